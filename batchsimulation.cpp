@@ -0,0 +1,263 @@
+/**
+ * @file batchsimulation.cpp
+ * @brief Runs many programs on one level in lockstep.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "batchsimulation.h"
+#include "bytecode.h"
+#include "zobrist.h"
+#include <memory>
+#include <vector>
+
+namespace {
+// Placed after every program, running into it loses.
+const int opHalt = 16;
+// Lane direction of a robot facing east, the start direction.
+const int laneEast = 1;
+// Lanes stepLanes handles at a time. A fixed trip count lets even the cheap
+// vectorizer cost model of -O2 replace the loop with whole vectors.
+const int LANE_BLOCK = 8;
+
+/**
+ * @brief stepLanes Moves into free cells, turns and jumps for every lane.
+ * Each op test is a 0 or 1 mask and each choice is masked arithmetic, and no
+ * array aliases another, so the loop has no control flow and vectorizes.
+ * @param count Lanes, a multiple of LANE_BLOCK.
+ */
+void stepLanes(int count, const int *__restrict op,
+               const int *__restrict target, const int *__restrict mask,
+               const int *__restrict negate, const int *__restrict offset,
+               const int *__restrict facing, int *__restrict cell,
+               int *__restrict dir, int *__restrict pc) {
+    for (int block = 0; block < count; block += LANE_BLOCK) {
+        for (int i = block; i < block + LANE_BLOCK; i++) {
+            int moves = (op[i] == opMove) & ((facing[i] & tileSolid) == 0);
+            cell[i] += offset[i] & -moves;
+            int turn = (op[i] == opTurnRight) + 3 * (op[i] == opTurnLeft);
+            dir[i] = (dir[i] + turn) & 3;
+            // Nothing is sensed past the edge of the map, even with "Not".
+            int inside = (facing[i] & tileOutside) == 0;
+            int sensed = (facing[i] & mask[i]) != 0;
+            int holds = inside & (sensed ^ negate[i]);
+            int jumps = (op[i] == opJump) | ((op[i] == opBranch) & (holds ^ 1));
+            pc[i] += 1 + ((target[i] - pc[i] - 1) & -jumps);
+        }
+    }
+}
+} // namespace
+
+BatchSimulation::BatchSimulation(
+        const std::vector<std::vector<MapTile>> &newLevel,
+        const std::vector<std::vector<ProgramBlock>> &newPrograms)
+    : level(newLevel), programs(newPrograms), shared(newLevel), cheeseCell(-1),
+      sharedBlockHash(0) {
+    // Without a start tile the robot starts in the top left corner.
+    startCell = shared.index(0, 0);
+    for (int y = 0; y < shared.getHeight(); y++) {
+        for (int x = 0; x < shared.getWidth(); x++) {
+            int cell = shared.index(x, y);
+            if (level[y][x] == start) {
+                startCell = cell;
+            }
+            if (level[y][x] == cheese) {
+                cheeseCell = cell;
+            }
+            if (shared.at(cell) & tileBlock) {
+                sharedBlockHash ^= blockKey(cell);
+            }
+        }
+    }
+    offsets[0] = shared.offset(north);
+    offsets[1] = shared.offset(east);
+    offsets[2] = shared.offset(south);
+    offsets[3] = shared.offset(west);
+
+    for (const std::vector<ProgramBlock> &program : programs) {
+        int base = codeOp.size();
+        codeBase.push_back(base);
+        for (const Instruction &instruction : compileProgram(program)) {
+            codeOp.push_back(instruction.op);
+            codeTarget.push_back(base + instruction.target);
+            codeMask.push_back(instruction.mask);
+            codeNegate.push_back(instruction.negate);
+        }
+        codeOp.push_back(opHalt);
+        codeTarget.push_back(0);
+        codeMask.push_back(0);
+        codeNegate.push_back(0);
+    }
+}
+
+std::vector<RunResult> BatchSimulation::run(int maxSteps) {
+    int count = programs.size();
+    results.assign(count, RunResult{notEnded, 0});
+    ownGrid.clear();
+    ownGrid.resize(count);
+    blockHash.assign(count, sharedBlockHash);
+    loopStates.assign(count, std::unordered_map<std::uint64_t, int>());
+
+    laneRobot.resize(count);
+    laneCell.assign(count, startCell);
+    laneDirection.assign(count, laneEast);
+    lanePc.resize(count);
+    laneTiles.assign(count, shared.data());
+    for (int robot = 0; robot < count; robot++) {
+        laneRobot[robot] = robot;
+        lanePc[robot] = codeBase[robot];
+    }
+
+    for (int tick = 1; tick <= maxSteps && !laneRobot.empty(); tick++) {
+        int lanes = laneRobot.size();
+        // The vector pass also steps a few padding lanes, which are dropped
+        // again right after it.
+        int padded = (lanes + LANE_BLOCK - 1) / LANE_BLOCK * LANE_BLOCK;
+        gatherOp.assign(padded, opNop);
+        gatherTarget.resize(padded);
+        gatherMask.resize(padded);
+        gatherNegate.resize(padded);
+        gatherOffset.resize(padded);
+        gatherFacing.resize(padded);
+
+        // Gather each lane's instruction and the tile in front of its robot.
+        // These are indirect loads, which stay scalar: SSE2 cannot gather.
+        for (int i = 0; i < lanes; i++) {
+            int pc = lanePc[i];
+            gatherOp[i] = codeOp[pc];
+            gatherTarget[i] = codeTarget[pc];
+            gatherMask[i] = codeMask[pc];
+            gatherNegate[i] = codeNegate[pc];
+            gatherOffset[i] = offsets[laneDirection[i]];
+            gatherFacing[i] = laneTiles[i][laneCell[i] + gatherOffset[i]];
+        }
+
+        laneCell.resize(padded);
+        laneDirection.resize(padded);
+        lanePc.resize(padded);
+        stepLanes(padded, gatherOp.data(), gatherTarget.data(),
+                  gatherMask.data(), gatherNegate.data(), gatherOffset.data(),
+                  gatherFacing.data(), laneCell.data(), laneDirection.data(),
+                  lanePc.data());
+        laneCell.resize(lanes);
+        laneDirection.resize(lanes);
+        lanePc.resize(lanes);
+
+        const int *op = gatherOp.data();
+        const int *facing = gatherFacing.data();
+        slowLanes.clear();
+        for (int i = 0; i < lanes; i++) {
+            if (op[i] == opEat || op[i] == opHalt || op[i] == opJump ||
+                    (op[i] == opMove && (facing[i] & (tileBlock | tilePit)))) {
+                slowLanes.push_back(i);
+            }
+        }
+        // Highest lane first, so removing a lane only moves one already seen.
+        for (auto lane = slowLanes.rbegin(); lane != slowLanes.rend(); lane++) {
+            if (stepSlow(*lane, tick)) {
+                removeLane(*lane);
+            }
+        }
+    }
+
+    // A loop may close before the limit without its head repeating, the
+    // single robot interpreter checks every step for these few.
+    for (int robot : laneRobot) {
+        SimulationCore simulation(level, programs[robot]);
+        results[robot] = simulation.runUntilDone(maxSteps);
+    }
+    laneRobot.clear();
+    ownGrid.clear();
+    loopStates.clear();
+    return results;
+}
+
+bool BatchSimulation::stepSlow(int lane, int tick) {
+    int robot = laneRobot[lane];
+    switch (gatherOp[lane]) {
+    case opHalt:
+        results[robot] = RunResult{lost, tick};
+        return true;
+    case opEat:
+        if (laneCell[lane] != cheeseCell)
+            return false;
+        results[robot] = RunResult{won, tick};
+        return true;
+    case opMove: {
+        int front = laneCell[lane] + gatherOffset[lane];
+        int behindCell = front + gatherOffset[lane];
+        unsigned char facing = gatherFacing[lane];
+        unsigned char behind =
+                facing & tileBlock ? laneTiles[lane][behindCell] : 0;
+        switch (moveOutcome(facing, behind)) {
+        case moveFalls:
+            results[robot] = RunResult{lost, tick};
+            return true;
+        case movePushes: {
+            TileGrid &tiles = ownTiles(lane);
+            tiles.set(behindCell, behind | tileBlock);
+            tiles.set(front, facing & ~tileBlock);
+            blockHash[robot] ^= blockKey(behindCell) ^ blockKey(front);
+            laneCell[lane] = front;
+            break;
+        }
+        case moveDropsBlock:
+            ownTiles(lane).set(front, facing & ~tileBlock);
+            blockHash[robot] ^= blockKey(front);
+            laneCell[lane] = front;
+            break;
+        case moveWalks:
+        case moveBlocked:
+            // Moves into free cells were taken by the vector loop.
+            break;
+        }
+        return false;
+    }
+    case opJump: {
+        // Every loop passes through the target of an end while jump, so
+        // states are only remembered there.
+        std::uint64_t hash =
+                blockHash[robot] ^ robotKey(lanePc[lane] - codeBase[robot],
+                                            laneCell[lane], laneDirection[lane]);
+        auto inserted = loopStates[robot].emplace(hash, tick);
+        if (inserted.second)
+            return false;
+        // Find the exact step the single robot interpreter stops on.
+        SimulationCore simulation(level, programs[robot]);
+        results[robot] =
+                simulation.runToFirstRepeat(tick - inserted.first->second);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+TileGrid &BatchSimulation::ownTiles(int lane) {
+    int robot = laneRobot[lane];
+    if (!ownGrid[robot]) {
+        ownGrid[robot] = std::make_unique<TileGrid>(shared);
+        laneTiles[lane] = ownGrid[robot]->data();
+    }
+    return *ownGrid[robot];
+}
+
+void BatchSimulation::removeLane(int lane) {
+    int robot = laneRobot[lane];
+    ownGrid[robot].reset();
+    loopStates[robot].clear();
+
+    int last = laneRobot.size() - 1;
+    laneRobot[lane] = laneRobot[last];
+    laneCell[lane] = laneCell[last];
+    laneDirection[lane] = laneDirection[last];
+    lanePc[lane] = lanePc[last];
+    laneTiles[lane] = laneTiles[last];
+    laneRobot.pop_back();
+    laneCell.pop_back();
+    laneDirection.pop_back();
+    lanePc.pop_back();
+    laneTiles.pop_back();
+}
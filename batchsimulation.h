@@ -0,0 +1,114 @@
+/**
+ * @file batchsimulation.h
+ * @brief Header file for batchsimulation.cpp, runs many programs on one level
+ * in lockstep.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef BATCHSIMULATION_H
+#define BATCHSIMULATION_H
+
+#include "constants.h"
+#include "simulationcore.h"
+#include "tilegrid.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// Grades many programs against the same level with the semantics of
+/// SimulationCore. Robots are kept as structure of arrays. Every tick gathers
+/// each robot's instruction and facing tile, a scalar pass, then moves, turns
+/// and jumps all of them in one branch-free pass that GCC vectorizes with
+/// SSE2 at -O2, wider with -march. Only moves into blocks or pits, eats,
+/// running off the end and loop heads take a per-robot path. Robots share
+/// the level until one pushes a block, which gives that robot its own copy of
+/// the grid.
+class BatchSimulation {
+private:
+    std::vector<std::vector<MapTile>> level;
+    std::vector<std::vector<ProgramBlock>> programs;
+    TileGrid shared;
+    int startCell;
+    int cheeseCell;
+    // Neighbour offsets in clockwise order, north first.
+    int offsets[4];
+    // XOR of blockKey over the blocks of the level.
+    std::uint64_t sharedBlockHash;
+
+    // Every compiled program back to back, each followed by a halt
+    // instruction, split into one array per field.
+    std::vector<int> codeOp;
+    std::vector<int> codeTarget;
+    std::vector<int> codeMask;
+    std::vector<int> codeNegate;
+    // Index of each program's first instruction.
+    std::vector<int> codeBase;
+
+    // Robots still running, one lane each. Directions count clockwise from
+    // north so a turn is an addition.
+    std::vector<int> laneRobot;
+    std::vector<int> laneCell;
+    std::vector<int> laneDirection;
+    std::vector<int> lanePc;
+    std::vector<const unsigned char *> laneTiles;
+
+    // Scratch values gathered for each lane every tick.
+    std::vector<int> gatherOp;
+    std::vector<int> gatherTarget;
+    std::vector<int> gatherMask;
+    std::vector<int> gatherNegate;
+    std::vector<int> gatherOffset;
+    std::vector<int> gatherFacing;
+    std::vector<int> slowLanes;
+
+    // Per robot state.
+    std::vector<std::unique_ptr<TileGrid>> ownGrid;
+    std::vector<std::uint64_t> blockHash;
+    std::vector<std::unordered_map<std::uint64_t, int>> loopStates;
+    std::vector<RunResult> results;
+
+public:
+    /**
+   * @brief BatchSimulation Compile the programs for one level.
+   * @param newLevel
+   * @param newPrograms Programs as produced by MachineGraph::getProgram.
+   */
+    BatchSimulation(const std::vector<std::vector<MapTile>> &newLevel,
+                    const std::vector<std::vector<ProgramBlock>> &newPrograms);
+
+    /**
+   * @brief run Run every program until it ends or has taken maxSteps steps.
+   * @param maxSteps
+   * @return One result per program, the same SimulationCore::runUntilDone
+   * would give.
+   */
+    std::vector<RunResult> run(int maxSteps);
+
+private:
+    /**
+   * @brief stepSlow Finish a tick for a lane the vector pass cannot handle.
+   * @param lane
+   * @param tick Steps executed after this tick.
+   * @return Whether the robot's run ended.
+   */
+    bool stepSlow(int lane, int tick);
+
+    /**
+   * @brief ownTiles Give a robot its own copy of the grid before it changes.
+   * @param lane
+   * @return
+   */
+    TileGrid &ownTiles(int lane);
+
+    /**
+   * @brief removeLane Drop a finished lane by moving the last lane into it.
+   * @param lane
+   */
+    void removeLane(int lane);
+};
+
+#endif // BATCHSIMULATION_H
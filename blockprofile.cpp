@@ -0,0 +1,53 @@
+/**
+ * @file blockprofile.cpp
+ * @brief Per block counters of where a run spends its steps.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "blockprofile.h"
+#include "programverifier.h"
+#include <vector>
+
+BlockProfile::BlockProfile() : totalSteps(0) {}
+
+BlockProfile::BlockProfile(const std::vector<ProgramBlock> &program)
+    : counters(program.size(), BlockCounters{0, 0, 0, 0}),
+      parents(program.size(), -1), totalSteps(0) {
+    std::vector<int> jumps = ProgramVerifier(program).getJumps();
+    std::vector<int> open;
+    for (unsigned long long index = 0; index < program.size(); index++) {
+        parents[index] = open.empty() ? -1 : open.back();
+        switch (program[index]) {
+        case ifStatement:
+        case whileLoop:
+            open.push_back(index);
+            break;
+        case endIf:
+        case endWhile:
+            // The end belongs inside the block it closes.
+            if (jumps[index] >= 0 && !open.empty())
+                open.pop_back();
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void BlockProfile::record(int block, int condition) {
+    if (block < 0 || block >= (int)counters.size())
+        return;
+    totalSteps++;
+    BlockCounters &counter = counters[block];
+    counter.executions++;
+    if (condition == 1)
+        counter.conditionTrue++;
+    else if (condition == 0)
+        counter.conditionFalse++;
+    for (int index = block; index >= 0; index = parents[index]) {
+        counters[index].steps++;
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file blockprofile.h
+ * @brief Header file for blockprofile.cpp, per block counters of where a run
+ * spends its steps.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef BLOCKPROFILE_H
+#define BLOCKPROFILE_H
+
+#include "constants.h"
+#include <vector>
+
+/// Counters of one source block.
+struct BlockCounters {
+    // Times the block was executed.
+    long long executions;
+    // Times the condition of an if or while held, and did not.
+    long long conditionTrue;
+    long long conditionFalse;
+    // Steps spent on the block and, for an if or while, on every block
+    // nested in it.
+    long long steps;
+};
+
+/// Counts executions per block of a program as a simulation runs it. Blocks
+/// are indexed like the source program, so MachineGraph's outputMap turns an
+/// index into an editor block. Recording a step is a few increments plus one
+/// per enclosing if or while.
+class BlockProfile {
+private:
+    std::vector<BlockCounters> counters;
+    // Program index of the innermost if or while around each block, -1 at
+    // the top level. Matched the same lenient way the compiler does.
+    std::vector<int> parents;
+    long long totalSteps;
+
+public:
+    BlockProfile();
+
+    /**
+   * @brief BlockProfile Create empty counters for a program.
+   * @param program
+   */
+    explicit BlockProfile(const std::vector<ProgramBlock> &program);
+
+    /**
+   * @brief record Count one executed block.
+   * @param block Program index of the block.
+   * @param condition 1 or 0 for a head whose condition held or not, -1 for
+   * any other block.
+   */
+    void record(int block, int condition);
+
+    /**
+   * @brief getCounters Get the counters of every program index. Condition
+   * slots and the begin block stay at 0.
+   * @return
+   */
+    const std::vector<BlockCounters> &getCounters() const { return counters; }
+
+    /**
+   * @brief getTotalSteps Get the number of steps recorded.
+   * @return
+   */
+    long long getTotalSteps() const { return totalSteps; }
+};
+
+#endif // BLOCKPROFILE_H
@@ -0,0 +1,128 @@
+/**
+ * @file bytecode.cpp
+ * @brief Compiles block programs into the flat instruction format.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "bytecode.h"
+#include "programverifier.h"
+#include "tilegrid.h"
+#include <vector>
+
+std::vector<Instruction> compileProgram(const std::vector<ProgramBlock> &program) {
+    return compileProgram(program, ProgramVerifier(program).getJumps());
+}
+
+std::vector<Instruction> compileProgram(const std::vector<ProgramBlock> &program,
+                                        const std::vector<int> &jumps) {
+    std::vector<Instruction> code;
+    // Index into code of every program index that starts a block.
+    std::vector<int> compiled(program.size(), -1);
+
+    // Block 0 is the begin block and is never executed.
+    for (unsigned long long index = 1; index < program.size(); index++) {
+        Instruction instruction{opNop, blank, false, 0, -1, (int)index,
+                                (int)code.size(), 1};
+        compiled[index] = code.size();
+        switch (program[index]) {
+        case moveForward:
+            instruction.op = opMove;
+            break;
+        case turnLeft:
+            instruction.op = opTurnLeft;
+            break;
+        case turnRight:
+            instruction.op = opTurnRight;
+            break;
+        case eatCheese:
+            instruction.op = opEat;
+            break;
+        case ifStatement:
+        case whileLoop:
+            instruction.op = opBranch;
+            if (index + 2 < program.size()) {
+                instruction.negate = program[index + 1] == conditionNot;
+                instruction.condition = program[index + 2];
+                instruction.mask = conditionMask(instruction.condition);
+            }
+            // Skip the two condition slots.
+            index += 2;
+            break;
+        case endIf:
+            if (jumps[index] >= 0) {
+                // A false condition resumes after the end if.
+                code[compiled[jumps[index]]].target = code.size() + 1;
+            }
+            break;
+        case endWhile:
+            if (jumps[index] >= 0) {
+                // A false condition leaves the loop, the end jumps back to
+                // re-evaluate the head.
+                int head = compiled[jumps[index]];
+                code[head].target = code.size() + 1;
+                instruction.op = opJump;
+                instruction.target = head;
+            }
+            break;
+        default:
+            break;
+        }
+        code.push_back(instruction);
+    }
+
+    // Unterminated heads fall off the end of the program.
+    for (Instruction &instruction : code) {
+        if (instruction.op == opBranch && instruction.target < 0)
+            instruction.target = code.size();
+    }
+    return code;
+}
+
+std::vector<Instruction> fuseProgram(const std::vector<Instruction> &code) {
+    std::vector<bool> isTarget(code.size() + 1, false);
+    for (const Instruction &instruction : code) {
+        if (instruction.op == opBranch || instruction.op == opJump) {
+            isTarget[instruction.target] = true;
+        }
+    }
+
+    std::vector<Instruction> fused;
+    unsigned long long index = 0;
+    while (index < code.size()) {
+        Instruction instruction = code[index];
+        bool turning = instruction.op == opTurnLeft ||
+                instruction.op == opTurnRight;
+        if (instruction.op != opMove && !turning) {
+            fused.push_back(instruction);
+            index++;
+            continue;
+        }
+
+        // Quarter turns clockwise.
+        int rotation = 0;
+        unsigned long long end = index;
+        while (end < code.size() && (end == index || !isTarget[end])) {
+            Opcode op = code[end].op;
+            if (turning && op == opTurnRight) {
+                rotation++;
+            } else if (turning && op == opTurnLeft) {
+                rotation += 3;
+            } else if (turning || op != opMove) {
+                break;
+            }
+            end++;
+        }
+
+        instruction.count = end - index;
+        if (instruction.count > 1) {
+            instruction.op = turning ? opRotate : opMoveN;
+            instruction.target = rotation % 4;
+        }
+        fused.push_back(instruction);
+        index = end;
+    }
+    return fused;
+}
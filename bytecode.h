@@ -0,0 +1,85 @@
+/**
+ * @file bytecode.h
+ * @brief Header file for bytecode.cpp, the flat instruction format the
+ * simulation interprets.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "constants.h"
+#include <vector>
+
+/// Operations understood by the interpreter.
+enum Opcode {
+    opNop = 0,
+    opMove = 1,
+    opTurnLeft = 2,
+    opTurnRight = 3,
+    opEat = 4,
+    // Jump to target when the condition does not hold (if / while head).
+    opBranch = 5,
+    // Unconditional jump to target (end while).
+    opJump = 6,
+    // Superinstructions produced by fuseProgram.
+    // Move forward count times, stopping early once the way is blocked.
+    opMoveN = 7,
+    // Turn by the net rotation of count turn blocks.
+    opRotate = 8,
+};
+
+/// A single compiled block. Conditions and jump targets are resolved at
+/// compile time so the interpreter never looks at neighbouring slots.
+struct Instruction {
+    Opcode op;
+    // Condition tested by opBranch, one of the conditionFacing* blocks.
+    ProgramBlock condition;
+    // Whether the condition was prefixed by a "Not" block.
+    bool negate;
+    // TileGrid class bits the condition tests the facing cell for.
+    unsigned char mask;
+    // Absolute index of the next instruction when the jump is taken. For
+    // opRotate, the number of quarter turns clockwise.
+    int target;
+    // Index of the block in the source program, reported by runningBlock.
+    int block;
+    // Range of compiled instructions [first, first + count) this instruction
+    // stands for. A plain instruction covers only itself.
+    int first;
+    int count;
+};
+
+/**
+ * @brief compileProgram Compile a program produced by MachineGraph into a
+ * flat instruction array. The begin block and condition slots are dropped.
+ * The ifs and whiles are matched by ProgramVerifier.
+ * @param program
+ * @return
+ */
+std::vector<Instruction> compileProgram(const std::vector<ProgramBlock> &program);
+
+/**
+ * @brief compileProgram Compile a program whose ifs and whiles were already
+ * matched.
+ * @param program
+ * @param jumps The jump table ProgramVerifier built for the program.
+ * @return
+ */
+std::vector<Instruction> compileProgram(const std::vector<ProgramBlock> &program,
+                                        const std::vector<int> &jumps);
+
+/**
+ * @brief fuseProgram Merge straight runs of moves, and of turns, into single
+ * opMoveN and opRotate superinstructions. Runs never extend over a jump
+ * target, so jump targets keep indexing the compiled program and every fused
+ * instruction starts at a compiled instruction.
+ * @param code Output of compileProgram.
+ * @return
+ */
+std::vector<Instruction> fuseProgram(const std::vector<Instruction> &code);
+
+#endif // BYTECODE_H
@@ -0,0 +1,57 @@
+/**
+ * @file byteorder.h
+ * @brief Little endian integers for the binary files: traces, level packs
+ * and the result cache.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef BYTEORDER_H
+#define BYTEORDER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief put32 Append a 32 bit value, low byte first.
+ * @param buffer
+ * @param value
+ */
+inline void put32(std::vector<unsigned char> &buffer, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        buffer.push_back((value >> shift) & 0xff);
+    }
+}
+
+/**
+ * @brief put64 Append a 64 bit value, low byte first.
+ * @param buffer
+ * @param value
+ */
+inline void put64(std::vector<unsigned char> &buffer, std::uint64_t value) {
+    put32(buffer, (std::uint32_t)value);
+    put32(buffer, (std::uint32_t)(value >> 32));
+}
+
+/**
+ * @brief get32 Read a 32 bit value written by put32.
+ * @param bytes
+ * @return
+ */
+inline std::uint32_t get32(const unsigned char *bytes) {
+    return (std::uint32_t)bytes[0] | ((std::uint32_t)bytes[1] << 8) |
+            ((std::uint32_t)bytes[2] << 16) | ((std::uint32_t)bytes[3] << 24);
+}
+
+/**
+ * @brief get64 Read a 64 bit value written by put64.
+ * @param bytes
+ * @return
+ */
+inline std::uint64_t get64(const unsigned char *bytes) {
+    return (std::uint64_t)get32(bytes) | ((std::uint64_t)get32(bytes + 4) << 32);
+}
+
+#endif // BYTEORDER_H
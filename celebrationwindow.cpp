@@ -110,7 +110,19 @@ void CelebrationWindow::showMainMenu() {
 }
 
 void CelebrationWindow::nextLevel() {
-    GameWindow* window = new GameWindow(levels[nextLevelIndex], nextLevelIndex, this);
+    LevelView map = LevelSelectWindow::levelAt(nextLevelIndex);
+    // Pack levels the game cannot play are passed over.
+    while (map.getWidth() == 0 &&
+           nextLevelIndex + 1 < LevelSelectWindow::levelCount()) {
+        nextLevelIndex++;
+        map = LevelSelectWindow::levelAt(nextLevelIndex);
+    }
+    // After the last level there is nothing left but the menu.
+    if (map.getWidth() == 0) {
+        showMainMenu();
+        return;
+    }
+    GameWindow* window = new GameWindow(map, nextLevelIndex, this);
     this->close();
     window->show();
 }
@@ -0,0 +1,96 @@
+/**
+ * @file chunkedmap.cpp
+ * @brief Sparse tile storage for worlds too big to allocate.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "chunkedmap.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+const std::uint64_t noChunk = ~(std::uint64_t)0;
+
+std::uint64_t chunkKey(int chunkX, int chunkY) {
+    return ((std::uint64_t)(std::uint32_t)chunkY << 32) | (std::uint32_t)chunkX;
+}
+
+} // namespace
+
+ChunkedMap::ChunkedMap() : ChunkedMap(0, 0, 0, 0) {}
+
+ChunkedMap::ChunkedMap(int width, int height, unsigned char fill,
+                       unsigned char outside, ChunkGenerator generator)
+    : width(width), height(height), fill(fill), outside(outside),
+      generator(generator), lastKey(noChunk), lastChunk(-1) {}
+
+unsigned char ChunkedMap::at(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return outside;
+    int index = findChunk(x, y, false);
+    if (index < 0)
+        return fill;
+    const Chunk &chunk = chunks[index];
+    if (chunk.tiles.empty())
+        return chunk.fill;
+    return chunk.tiles[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE];
+}
+
+void ChunkedMap::set(int x, int y, unsigned char value) {
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return;
+    Chunk &chunk = chunks[findChunk(x, y, true)];
+    if (chunk.tiles.empty()) {
+        if (value == chunk.fill)
+            return;
+        chunk.tiles.assign(CHUNK_SIZE * CHUNK_SIZE, chunk.fill);
+    }
+    chunk.tiles[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE] = value;
+}
+
+int ChunkedMap::getStoredChunkCount() const {
+    int stored = 0;
+    for (const Chunk &chunk : chunks) {
+        stored += !chunk.tiles.empty();
+    }
+    return stored;
+}
+
+int ChunkedMap::findChunk(int x, int y, bool create) const {
+    int chunkX = x >> CHUNK_BITS;
+    int chunkY = y >> CHUNK_BITS;
+    std::uint64_t key = chunkKey(chunkX, chunkY);
+    if (key == lastKey)
+        return lastChunk;
+
+    auto found = chunkIndex.find(key);
+    if (found != chunkIndex.end()) {
+        lastKey = key;
+        lastChunk = found->second;
+        return lastChunk;
+    }
+    if (!create && !generator)
+        return -1;
+
+    Chunk chunk{fill, {}};
+    if (generator) {
+        std::vector<unsigned char> tiles(CHUNK_SIZE * CHUNK_SIZE, fill);
+        generator(chunkX, chunkY, tiles);
+        // Keep only the value of a uniform chunk.
+        if (std::count(tiles.begin(), tiles.end(), tiles[0]) == (long)tiles.size()) {
+            chunk.fill = tiles[0];
+        } else {
+            chunk.tiles.swap(tiles);
+        }
+    }
+    chunks.push_back(chunk);
+    chunkIndex[key] = chunks.size() - 1;
+    lastKey = key;
+    lastChunk = chunks.size() - 1;
+    return lastChunk;
+}
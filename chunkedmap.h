@@ -0,0 +1,118 @@
+/**
+ * @file chunkedmap.h
+ * @brief Header file for chunkedmap.cpp, sparse tile storage for worlds too
+ * big to allocate.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef CHUNKEDMAP_H
+#define CHUNKEDMAP_H
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/// Fills a chunk the first time it is read. Gets the chunk column and row and
+/// CHUNK_SIZE * CHUNK_SIZE tiles in reading order, all set to the map's fill
+/// value. Tiles past the edge of the world are ignored.
+typedef std::function<void(int chunkX, int chunkY,
+                           std::vector<unsigned char> &tiles)>
+        ChunkGenerator;
+
+/// One byte per tile of a world, stored in square chunks that only exist
+/// once something is read from or written to them. What a byte means is up
+/// to the owner: the interpreter keeps TileGrid class bits, the canvas keeps
+/// MapTile values. A chunk whose tiles are all the same, such as solid rock
+/// or open floor, keeps a single byte instead of its tiles until one of them
+/// is changed. Without a generator untouched chunks are not stored at all, so
+/// a 100000 x 100000 world costs nothing up front.
+class ChunkedMap {
+public:
+    static const int CHUNK_BITS = 6;
+    static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+
+private:
+    struct Chunk {
+        // Value of every tile while tiles is empty.
+        unsigned char fill;
+        std::vector<unsigned char> tiles;
+    };
+
+    int width;
+    int height;
+    // Value of tiles in chunks nobody generated or wrote.
+    unsigned char fill;
+    // Value read for coordinates outside the world.
+    unsigned char outside;
+    ChunkGenerator generator;
+    // Chunks are filled in by reads too, so they change even in const calls.
+    mutable std::vector<Chunk> chunks;
+    // Index into chunks of every chunk key.
+    mutable std::unordered_map<std::uint64_t, int> chunkIndex;
+    // The chunk looked up last, most reads stay in one chunk.
+    mutable std::uint64_t lastKey;
+    mutable int lastChunk;
+
+public:
+    ChunkedMap();
+
+    /**
+   * @brief ChunkedMap Make a world without allocating any of it.
+   * @param width
+   * @param height
+   * @param fill Value of every tile not generated or written.
+   * @param outside Value read past the edge of the world.
+   * @param generator Fills chunks on their first use, may be empty.
+   */
+    ChunkedMap(int width, int height, unsigned char fill, unsigned char outside,
+               ChunkGenerator generator = ChunkGenerator());
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    /**
+   * @brief at Get a tile, generating its chunk if needed.
+   * @param x
+   * @param y
+   * @return The outside value for coordinates past the edge.
+   */
+    unsigned char at(int x, int y) const;
+
+    /**
+   * @brief set Replace a tile. Writes past the edge are ignored.
+   * @param x
+   * @param y
+   * @param value
+   */
+    void set(int x, int y, unsigned char value);
+
+    /**
+   * @brief getChunkCount Get the number of chunks in memory.
+   * @return
+   */
+    int getChunkCount() const { return chunks.size(); }
+
+    /**
+   * @brief getStoredChunkCount Get the number of chunks that keep every
+   * tile, the rest are uniform.
+   * @return
+   */
+    int getStoredChunkCount() const;
+
+private:
+    /**
+   * @brief findChunk Look up the chunk holding a tile.
+   * @param x
+   * @param y
+   * @param create Whether to make the chunk when it does not exist yet.
+   * Chunks are always made when there is a generator.
+   * @return Index into chunks, -1 if the chunk does not exist.
+   */
+    int findChunk(int x, int y, bool create) const;
+};
+
+#endif // CHUNKEDMAP_H
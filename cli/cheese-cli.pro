@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = cheese-cli
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+include(../core.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,468 @@
+/**
+ * @file main.cpp
+ * @brief Headless runner that grades many programs against one level without
+ * a QApplication.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "batchsimulation.h"
+#include "chunkedmap.h"
+#include "constants.h"
+#include "levelgenerator.h"
+#include "levelpack.h"
+#include "multisimulation.h"
+#include "resultcache.h"
+#include "simulationcore.h"
+#include "solver.h"
+#include "startsweep.h"
+#include "textformat.h"
+#include "tilegrid.h"
+#include "trace.h"
+#include "worldsimulation.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const int DEFAULT_MAX_STEPS = 10000;
+
+void printUsage() {
+    std::cerr << "usage: cheese-cli [--max-steps N] [--cache <file>] <level> "
+                 "[program-file...]\n"
+                 "       cheese-cli --solve [--max-blocks N] [--threads N] "
+                 "<level>\n"
+                 "       cheese-cli --trace <file> <level> [program-file]\n"
+                 "       cheese-cli --replay <file> [tick]\n"
+                 "       cheese-cli --sweep <level> [program-file]\n"
+                 "       cheese-cli --generate N [--difficulty D] [--seed S] "
+                 "[--threads N] <directory|pack>\n"
+                 "       cheese-cli --pack <pack> <level>...\n"
+                 "       cheese-cli --world N [--difficulty D] [--seed S] "
+                 "[program-file...]\n"
+                 "  <level> is a built-in level number, a level file or "
+                 "<pack>:<number>.\n"
+                 "  Every robot of a level with several runs the program.\n"
+                 "  Without program files, one program per line is read from "
+                 "standard input.\n"
+                 "  --cache keeps results in a file, so programs graded before "
+                 "on the level are\n"
+                 "  not run again.\n"
+                 "  --solve prints the shortest winning program.\n"
+                 "  --trace records the run of a single program to a file.\n"
+                 "  --replay prints a recorded run at a tick (default: the "
+                 "end).\n"
+                 "  --sweep runs a single program from every cell and heading "
+                 "and maps how many\n"
+                 "  headings win from each cell.\n"
+                 "  --generate writes N solvable levels of difficulty 1 to 10 "
+                 "(default 3) into\n"
+                 "  the directory, or into one level pack if the name ends in "
+                 ".pack.\n"
+                 "  --pack writes levels into a level pack.\n"
+                 "  --world runs programs on a generated N x N world, made "
+                 "chunk by chunk where\n"
+                 "  the robot looks, starting in the middle facing east.\n";
+}
+
+const char *stateName(gameState state) {
+    switch (state) {
+    case won:
+        return "won";
+    case lost:
+        return "lost";
+    case nonTerminating:
+        return "nonterminating";
+    case notEnded:
+        break;
+    }
+    return "unfinished";
+}
+
+/// A program read from a file or a line of standard input.
+struct Submission {
+    std::string name;
+    std::vector<ProgramBlock> program;
+    // Parse error, empty if the program is valid.
+    std::string error;
+};
+
+void addSubmission(const std::string &name, const std::string &text,
+                   std::vector<Submission> &submissions) {
+    Submission submission{name, {}, ""};
+    parseProgram(text, submission.program, submission.error);
+    submissions.push_back(submission);
+}
+
+/// Programs from files, or one per line of standard input without files.
+std::vector<Submission> readSubmissions(const std::vector<std::string> &files) {
+    std::vector<Submission> submissions;
+    if (files.empty()) {
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(std::cin, line)) {
+            lineNumber++;
+            if (line.empty())
+                continue;
+            addSubmission("line " + std::to_string(lineNumber), line,
+                          submissions);
+        }
+    }
+
+    for (const std::string &file : files) {
+        std::string text;
+        if (!readFile(file, text)) {
+            submissions.push_back(Submission{file, {}, "cannot read file"});
+            continue;
+        }
+        addSubmission(file, text, submissions);
+    }
+    return submissions;
+}
+
+void grade(const std::vector<Submission> &submissions,
+           const std::vector<std::vector<MapTile>> &level, int maxSteps,
+           ResultCache *cache) {
+    // Only programs the cache does not know are run, each of them once.
+    std::vector<RunResult> results(submissions.size());
+    std::vector<ResultKey> keys(submissions.size());
+    // Index into programs of the run that answers each submission.
+    std::vector<int> runs(submissions.size(), -1);
+    std::unordered_map<ResultKey, int, ResultKeyHash> firstRun;
+    std::vector<int> pending;
+    std::vector<std::vector<ProgramBlock>> programs;
+    for (unsigned long long i = 0; i < submissions.size(); i++) {
+        if (!submissions[i].error.empty())
+            continue;
+        if (cache) {
+            keys[i] = resultKey(level, submissions[i].program);
+            if (cache->lookup(keys[i], maxSteps, results[i]))
+                continue;
+            auto known = firstRun.emplace(keys[i], programs.size());
+            if (!known.second) {
+                runs[i] = known.first->second;
+                continue;
+            }
+        }
+        runs[i] = programs.size();
+        pending.push_back(i);
+        programs.push_back(submissions[i].program);
+    }
+
+    std::vector<RunResult> ran;
+    if (hasManyRobots(level)) {
+        // Every robot of the level runs the same program.
+        for (const std::vector<ProgramBlock> &program : programs) {
+            MultiSimulation simulation(level, {program});
+            ran.push_back(simulation.runUntilDone(maxSteps));
+        }
+    } else if (!programs.empty()) {
+        // All valid programs run together in lockstep.
+        BatchSimulation batch(level, programs);
+        ran = batch.run(maxSteps);
+    }
+    for (unsigned long long i = 0; i < pending.size(); i++) {
+        if (cache)
+            cache->store(keys[pending[i]], maxSteps, ran[i]);
+    }
+    for (unsigned long long i = 0; i < submissions.size(); i++) {
+        if (runs[i] >= 0)
+            results[i] = ran[runs[i]];
+    }
+
+    for (unsigned long long i = 0; i < submissions.size(); i++) {
+        const Submission &submission = submissions[i];
+        if (!submission.error.empty()) {
+            std::cout << submission.name << "\terror\t" << submission.error
+                      << "\n";
+            continue;
+        }
+        const RunResult &result = results[i];
+        std::cout << submission.name << "\t" << stateName(result.state) << "\t"
+                  << result.steps << "\n";
+    }
+}
+
+int record(const std::vector<Submission> &submissions,
+           const std::vector<std::vector<MapTile>> &level, int maxSteps,
+           const std::string &path) {
+    if (submissions.size() != 1 || !submissions[0].error.empty()) {
+        std::cerr << "cheese-cli: --trace needs exactly one valid program\n";
+        return 1;
+    }
+    SimulationCore simulation(level, submissions[0].program);
+    TraceWriter trace;
+    simulation.setTrace(&trace);
+    RunResult result = simulation.runUntilDone(maxSteps);
+    if (!trace.save(path)) {
+        std::cerr << "cheese-cli: cannot write " << path << "\n";
+        return 1;
+    }
+    std::cout << submissions[0].name << "\t" << stateName(result.state) << "\t"
+              << result.steps << "\n";
+    return 0;
+}
+
+int replay(const std::string &path, const std::vector<std::string> &arguments) {
+    TraceReader reader;
+    std::string error;
+    if (!reader.open(path, error)) {
+        std::cerr << "cheese-cli: " << error << "\n";
+        return 1;
+    }
+    int tick = arguments.empty() ? reader.getLastTick()
+                                 : std::atoi(arguments[0].c_str());
+    TraceFrame frame;
+    if (!reader.seek(tick, frame)) {
+        std::cerr << "cheese-cli: " << path << " is damaged\n";
+        return 1;
+    }
+
+    std::cout << "tick " << frame.tick << "\t" << stateName(frame.state)
+              << "\tblock " << frame.block << "\n";
+    const char robotSymbols[] = {'^', 'v', '>', '<'};
+    const char tileSymbols[] = {'*', '*', '#', 'C', '@', '0'};
+    for (int y = 0; y < (int)frame.map.size(); y++) {
+        for (int x = 0; x < (int)frame.map[y].size(); x++) {
+            if (frame.robot == Point{x, y}) {
+                std::cout << robotSymbols[frame.robotDirection];
+            } else {
+                std::cout << tileSymbols[frame.map[y][x]];
+            }
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+int sweep(const std::vector<Submission> &submissions,
+          const std::vector<std::vector<MapTile>> &level, int maxSteps) {
+    if (submissions.size() != 1 || !submissions[0].error.empty()) {
+        std::cerr << "cheese-cli: --sweep needs exactly one valid program\n";
+        return 1;
+    }
+    StartSweep starts(level, submissions[0].program);
+    int counts[4] = {0, 0, 0, 0};
+    std::vector<std::string> rows;
+    const char tileSymbols[] = {'*', '*', '#', 'C', '@', '0'};
+    for (int y = 0; y < starts.getHeight(); y++) {
+        std::string row;
+        for (int x = 0; x < starts.getWidth(); x++) {
+            if (!starts.canStart(x, y)) {
+                row += tileSymbols[level[y][x]];
+                continue;
+            }
+            // Each cell shows how many headings win from it.
+            int wins = 0;
+            for (int dir = north; dir <= west; dir++) {
+                RunResult result = starts.run(x, y, (direction)dir, maxSteps);
+                counts[result.state]++;
+                wins += result.state == won;
+            }
+            row += '0' + wins;
+        }
+        rows.push_back(row);
+    }
+
+    std::cout << "won " << counts[won] << "\tlost " << counts[lost]
+              << "\tnonterminating " << counts[nonTerminating]
+              << "\tunfinished " << counts[notEnded] << "\tstates "
+              << starts.getStateCount() << "\n";
+    for (const std::string &row : rows) {
+        std::cout << row << "\n";
+    }
+    return 0;
+}
+
+int solve(const std::vector<std::vector<MapTile>> &level,
+          const SolverOptions &options) {
+    SolverResult result = solveLevel(level, options);
+    if (!result.solved) {
+        std::cout << "unsolved\t" << result.nodes << "\n";
+        return 1;
+    }
+    std::cout << "solved\t" << result.blocks.size() << "\t"
+              << formatProgram(result.program) << "\n";
+    return 0;
+}
+
+int generate(const GeneratorOptions &options, const std::string &directory) {
+    GeneratorResult result = generateLevels(options);
+    std::cerr << result.levels.size() << " levels from " << result.candidates
+              << " candidates\n";
+    int status = (int)result.levels.size() == options.count ? 0 : 1;
+
+    const std::string extension = ".pack";
+    if (directory.size() > extension.size() &&
+            directory.compare(directory.size() - extension.size(),
+                              extension.size(), extension) == 0) {
+        std::vector<std::vector<std::vector<MapTile>>> levels;
+        for (const GeneratedLevel &level : result.levels) {
+            levels.push_back(level.level);
+        }
+        if (!saveLevelPack(directory, levels)) {
+            std::cerr << "cheese-cli: cannot write " << directory << "\n";
+            return 1;
+        }
+        return status;
+    }
+
+    for (unsigned long long i = 0; i < result.levels.size(); i++) {
+        const GeneratedLevel &level = result.levels[i];
+        std::string path = directory + "/level" + std::to_string(i + 1) + ".txt";
+        std::ofstream file(path);
+        file << formatLevel(level.level);
+        if (!file) {
+            std::cerr << "cheese-cli: cannot write " << path << "\n";
+            return 1;
+        }
+        std::cout << path << "\tpushes " << level.check.pushes << "\tseed "
+                  << level.seed << "\n";
+    }
+    return status;
+}
+
+int explore(const std::vector<Submission> &submissions, int size,
+            const GeneratorOptions &options, int maxSteps) {
+    ChunkedMap world(size, size, 0, tileOutside,
+                     worldGenerator(options.difficulty, options.seed));
+    int middle = size / 2;
+    // The robot starts on open ground.
+    world.set(middle, middle, 0);
+    for (const Submission &submission : submissions) {
+        if (!submission.error.empty()) {
+            std::cout << submission.name << "\terror\t" << submission.error
+                      << "\n";
+            continue;
+        }
+        WorldSimulation simulation(world, middle, middle, east,
+                                   submission.program);
+        RunResult result = simulation.runUntilDone(maxSteps);
+        std::cout << submission.name << "\t" << stateName(result.state) << "\t"
+                  << result.steps << "\tchunks "
+                  << simulation.getWorld().getChunkCount() << "\n";
+    }
+    return 0;
+}
+
+int pack(const std::vector<std::string> &arguments) {
+    std::vector<std::vector<std::vector<MapTile>>> levels;
+    for (unsigned long long i = 1; i < arguments.size(); i++) {
+        std::vector<std::vector<MapTile>> level;
+        std::string error;
+        if (!loadLevel(arguments[i], level, error)) {
+            std::cerr << "cheese-cli: " << error << "\n";
+            return 1;
+        }
+        levels.push_back(level);
+    }
+    if (!saveLevelPack(arguments[0], levels)) {
+        std::cerr << "cheese-cli: cannot write " << arguments[0] << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int maxSteps = DEFAULT_MAX_STEPS;
+    bool solving = false;
+    bool sweeping = false;
+    std::string tracePath;
+    std::string replayPath;
+    std::string cachePath;
+    SolverOptions solverOptions;
+    bool generating = false;
+    bool packing = false;
+    int worldSize = 0;
+    GeneratorOptions generatorOptions;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--max-steps" && i + 1 < argc) {
+            maxSteps = std::atoi(argv[++i]);
+            solverOptions.maxSteps = maxSteps;
+        } else if (argument == "--cache" && i + 1 < argc) {
+            cachePath = argv[++i];
+        } else if (argument == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (argument == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (argument == "--solve") {
+            solving = true;
+        } else if (argument == "--sweep") {
+            sweeping = true;
+        } else if (argument == "--max-blocks" && i + 1 < argc) {
+            solverOptions.maxBlocks = std::atoi(argv[++i]);
+        } else if (argument == "--threads" && i + 1 < argc) {
+            solverOptions.threads = std::atoi(argv[++i]);
+            generatorOptions.threads = solverOptions.threads;
+        } else if (argument == "--generate" && i + 1 < argc) {
+            generating = true;
+            generatorOptions.count = std::atoi(argv[++i]);
+        } else if (argument == "--pack") {
+            packing = true;
+        } else if (argument == "--world" && i + 1 < argc) {
+            worldSize = std::atoi(argv[++i]);
+        } else if (argument == "--difficulty" && i + 1 < argc) {
+            generatorOptions.difficulty = std::atoi(argv[++i]);
+        } else if (argument == "--seed" && i + 1 < argc) {
+            generatorOptions.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "-h" || argument == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+    if (!replayPath.empty())
+        return replay(replayPath, arguments);
+    if (generating && arguments.size() == 1)
+        return generate(generatorOptions, arguments[0]);
+    if (packing && arguments.size() >= 2)
+        return pack(arguments);
+    if (worldSize > 0 && !generating && !packing)
+        return explore(readSubmissions(arguments), worldSize, generatorOptions,
+                       maxSteps);
+    if (generating || packing || arguments.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<std::vector<MapTile>> level;
+    std::string error;
+    if (!loadLevel(arguments[0], level, error)) {
+        std::cerr << "cheese-cli: " << error << "\n";
+        return 1;
+    }
+
+    if ((solving || sweeping || !tracePath.empty()) && hasManyRobots(level)) {
+        std::cerr << "cheese-cli: only grading supports levels with several "
+                     "robots or cheese tiles\n";
+        return 1;
+    }
+    if (solving)
+        return solve(level, solverOptions);
+
+    std::vector<Submission> submissions = readSubmissions(
+                std::vector<std::string>(arguments.begin() + 1, arguments.end()));
+    if (!tracePath.empty())
+        return record(submissions, level, maxSteps, tracePath);
+    if (sweeping)
+        return sweep(submissions, level, maxSteps);
+    ResultCache cache;
+    if (!cachePath.empty() && !cache.open(cachePath, error)) {
+        std::cerr << "cheese-cli: " << error << "\n";
+        return 1;
+    }
+    grade(submissions, level, maxSteps, cachePath.empty() ? nullptr : &cache);
+    return 0;
+}
@@ -12,9 +12,9 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include <cstddef>
 #include <map>
 #include <vector>
-#include <QString>
 
 enum MapTile {
     start = 0,
@@ -48,6 +48,8 @@ enum gameState {
     notEnded = 0,
     won = 1,
     lost = 2,
+    // The program revisited an earlier state, so it would loop forever.
+    nonTerminating = 3,
 };
 
 enum direction {
@@ -57,102 +59,163 @@ enum direction {
     west = 3
 };
 
-/// Defines the levels for the game
-const std::vector<std::vector<MapTile>> levels[] = {
-    // Level 1
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{ground, start, ground,  ground,  cheese, ground}
-    },
-
-    // Level 2
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground,  wall,   cheese},
-        std::vector<MapTile>{wall,  ground,  ground,  ground },
-        std::vector<MapTile>{wall,  wall,  wall,  wall }
-    },
-
-    // Level 3
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground, block,  ground,  ground},
-        std::vector<MapTile>{wall,  wall,  wall, ground,  wall},
-        std::vector<MapTile>{wall,  wall,  wall, cheese,  wall},
-        std::vector<MapTile>{wall,  wall,  wall, wall,  wall}
-    },
-
-    // Level 4
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground, ground,  ground,  ground,  ground, wall },
-        std::vector<MapTile>{wall,  wall,   wall,    wall,    wall,    ground, wall },
-        std::vector<MapTile>{wall,  ground, ground,  ground,  wall,    ground, wall },
-        std::vector<MapTile>{wall,  ground, wall,    cheese,  wall,    ground, wall },
-        std::vector<MapTile>{wall,  ground, wall,    wall,    wall,    ground, wall },
-        std::vector<MapTile>{wall,  ground, ground,  ground,  ground,  ground, wall },
-        std::vector<MapTile>{wall,  wall,   wall,    wall,    wall,    wall, wall }
-    },
-
-    // Level 5
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground, ground,  ground,  ground,  wall },
-        std::vector<MapTile>{wall,  wall,   wall,    wall,    ground,  wall },
-        std::vector<MapTile>{wall,  ground, ground,  ground,  ground ,  wall },
-        std::vector<MapTile>{wall,  ground, wall,    wall,    wall,     wall },
-        std::vector<MapTile>{wall,  ground, ground,  ground,  ground,  wall },
-        std::vector<MapTile>{wall,  wall,   wall,    wall,    ground,  wall },
-        std::vector<MapTile>{wall,  cheese, ground,  ground,  ground ,  wall },
-        std::vector<MapTile>{wall,  wall, wall,    wall,    wall,     wall }
-    },
-
-    // Level 6
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground,  wall,   wall,    wall,   cheese, wall},
-        std::vector<MapTile>{wall,  ground,  wall,   ground,  ground, ground, pit},
-        std::vector<MapTile>{wall,  ground,  block, ground,  pit,    wall,   wall},
-        std::vector<MapTile>{wall,  pit,     wall,   wall,    wall,   wall,   wall}
-    },
-
-
-    // Level 7
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground, ground, ground, ground, wall },
-        std::vector<MapTile>{wall, wall,    wall,   wall,   block, wall },
-        std::vector<MapTile>{wall, ground,  ground, ground, ground, wall },
-        std::vector<MapTile>{wall, ground,  wall,   wall,   ground, wall },
-        std::vector<MapTile>{wall, ground,  ground, ground, ground, cheese },
-        std::vector<MapTile>{wall, wall, wall, wall, wall, wall }
-    },
-
-
-    // Level 8
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, wall,  cheese, wall, pit, wall,   wall},
-        std::vector<MapTile>{ground, ground,  block, block, block, ground,   wall},
-        std::vector<MapTile>{ground, ground,  ground, ground, ground, pit,   wall},
-        std::vector<MapTile>{wall, wall,  wall, wall, wall, wall,   wall}
-    },
-
-    // Level 9
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground,  ground, ground, ground, wall,   wall,   wall,   wall,   wall},
-        std::vector<MapTile>{wall,  wall,    wall,   wall,   block,  wall,   ground, ground, ground, wall },
-        std::vector<MapTile>{wall,  ground,  ground, ground, ground, wall,   ground, wall,   ground, wall },
-        std::vector<MapTile>{wall,  ground,  wall,   wall,   ground, wall,   ground, wall,   ground, wall },
-        std::vector<MapTile>{wall,  ground,  ground, ground, ground, ground, block, ground, ground, wall },
-        std::vector<MapTile>{wall,  wall,    wall,   wall,   wall,   wall,   wall,   wall,   cheese, wall }
-    },
-
-    // Level 10
-    std::vector<std::vector<MapTile>>{
-        std::vector<MapTile>{start, ground,  wall, wall, wall},
-        std::vector<MapTile>{wall,  ground,  ground, wall, wall },
-        std::vector<MapTile>{wall,  wall,  ground,   ground,   wall },
-        std::vector<MapTile>{wall,  wall,  wall, ground, ground  },
-        std::vector<MapTile>{wall,  wall,  wall,   wall,   cheese    }
+/// Read-only view of a level's tiles. It points either at a constexpr table
+/// of tiles in reading order or at a nested vector, and never copies them,
+/// so the tiles must outlive the view. Functions that only read a level take
+/// a LevelView, so both kinds of level can be passed without building a
+/// copy.
+class LevelView {
+private:
+    // Tiles of a table in reading order, nullptr when viewing a nested vector.
+    const MapTile *tiles;
+    const std::vector<std::vector<MapTile>> *rows;
+    int width;
+    int height;
+
+public:
+    constexpr LevelView() : tiles(nullptr), rows(nullptr), width(0), height(0) {}
+
+    template <std::size_t Size>
+    constexpr LevelView(const MapTile (&table)[Size], int width)
+        : tiles(table), rows(nullptr), width(width), height(Size / width) {}
+
+    LevelView(const std::vector<std::vector<MapTile>> &level)
+        : tiles(nullptr), rows(&level),
+          width(level.empty() ? 0 : level[0].size()), height(level.size()) {}
+
+    constexpr int getWidth() const { return width; }
+    constexpr int getHeight() const { return height; }
+
+    constexpr MapTile at(int x, int y) const {
+        return tiles ? tiles[y * width + x] : (*rows)[y][x];
+    }
+
+    // Copies the tiles, for code that keeps or edits its own map
+    std::vector<std::vector<MapTile>> toVector() const {
+        std::vector<std::vector<MapTile>> level(height, std::vector<MapTile>(width));
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                level[y][x] = at(x, y);
+            }
+        }
+        return level;
     }
+};
+
+/// Tiles of the built-in levels in reading order, written a row per line;
+/// levels below gives the width of each. Constexpr tables are built by the
+/// compiler, so no level is allocated at startup, and being inline every
+/// translation unit shares one copy.
+namespace levelTiles {
+// Level 1
+inline constexpr MapTile level1[] = {
+    ground, start, ground,  ground,  cheese, ground
+};
+
+// Level 2
+inline constexpr MapTile level2[] = {
+    start, ground,  wall,   cheese,
+    wall,  ground,  ground,  ground,
+    wall,  wall,  wall,  wall
+};
+
+// Level 3
+inline constexpr MapTile level3[] = {
+    start, ground, block,  ground,  ground,
+    wall,  wall,  wall, ground,  wall,
+    wall,  wall,  wall, cheese,  wall,
+    wall,  wall,  wall, wall,  wall
+};
+
+// Level 4
+inline constexpr MapTile level4[] = {
+    start, ground, ground,  ground,  ground,  ground, wall,
+    wall,  wall,   wall,    wall,    wall,    ground, wall,
+    wall,  ground, ground,  ground,  wall,    ground, wall,
+    wall,  ground, wall,    cheese,  wall,    ground, wall,
+    wall,  ground, wall,    wall,    wall,    ground, wall,
+    wall,  ground, ground,  ground,  ground,  ground, wall,
+    wall,  wall,   wall,    wall,    wall,    wall, wall
+};
+
+// Level 5
+inline constexpr MapTile level5[] = {
+    start, ground, ground,  ground,  ground,  wall,
+    wall,  wall,   wall,    wall,    ground,  wall,
+    wall,  ground, ground,  ground,  ground ,  wall,
+    wall,  ground, wall,    wall,    wall,     wall,
+    wall,  ground, ground,  ground,  ground,  wall,
+    wall,  wall,   wall,    wall,    ground,  wall,
+    wall,  cheese, ground,  ground,  ground ,  wall,
+    wall,  wall, wall,    wall,    wall,     wall
+};
 
+// Level 6
+inline constexpr MapTile level6[] = {
+    start, ground,  wall,   wall,    wall,   cheese, wall,
+    wall,  ground,  wall,   ground,  ground, ground, pit,
+    wall,  ground,  block, ground,  pit,    wall,   wall,
+    wall,  pit,     wall,   wall,    wall,   wall,   wall
 };
 
+// Level 7
+inline constexpr MapTile level7[] = {
+    start, ground, ground, ground, ground, wall,
+    wall, wall,    wall,   wall,   block, wall,
+    wall, ground,  ground, ground, ground, wall,
+    wall, ground,  wall,   wall,   ground, wall,
+    wall, ground,  ground, ground, ground, cheese,
+    wall, wall, wall, wall, wall, wall
+};
+
+// Level 8
+inline constexpr MapTile level8[] = {
+    start, wall,  cheese, wall, pit, wall,   wall,
+    ground, ground,  block, block, block, ground,   wall,
+    ground, ground,  ground, ground, ground, pit,   wall,
+    wall, wall,  wall, wall, wall, wall,   wall
+};
+
+// Level 9
+inline constexpr MapTile level9[] = {
+    start, ground,  ground, ground, ground, wall,   wall,   wall,   wall,   wall,
+    wall,  wall,    wall,   wall,   block,  wall,   ground, ground, ground, wall,
+    wall,  ground,  ground, ground, ground, wall,   ground, wall,   ground, wall,
+    wall,  ground,  wall,   wall,   ground, wall,   ground, wall,   ground, wall,
+    wall,  ground,  ground, ground, ground, ground, block, ground, ground, wall,
+    wall,  wall,    wall,   wall,   wall,   wall,   wall,   wall,   cheese, wall
+};
+
+// Level 10
+inline constexpr MapTile level10[] = {
+    start, ground,  wall, wall, wall,
+    wall,  ground,  ground, wall, wall,
+    wall,  wall,  ground,   ground,   wall,
+    wall,  wall,  wall, ground, ground,
+    wall,  wall,  wall,   wall,   cheese
+};
+
+} // namespace levelTiles
+
+/// Defines the levels for the game
+inline constexpr LevelView levels[] = {
+    LevelView(levelTiles::level1, 6),
+    LevelView(levelTiles::level2, 4),
+    LevelView(levelTiles::level3, 5),
+    LevelView(levelTiles::level4, 7),
+    LevelView(levelTiles::level5, 6),
+    LevelView(levelTiles::level6, 7),
+    LevelView(levelTiles::level7, 6),
+    LevelView(levelTiles::level8, 7),
+    LevelView(levelTiles::level9, 10),
+    LevelView(levelTiles::level10, 5)
+};
+
+/// Number of built-in levels
+inline constexpr int builtInLevelCount = sizeof(levels) / sizeof(levels[0]);
+
 /// These messages are shown at the beginning of each level, to help the user learn and encourage them!
-const auto educationalMessages = std::vector<QString>{
+inline constexpr const char *educationalMessages[] = {
         //Level 1
         "Welcome!\n\nThe mice need your help.\nThey've built and designed a new robot to make cheese collection quick and efficient. But, without programming, the robot can't do anything!\n\nWill you write a program to help the robot reach the cheese? Just moving forward a few times should be a good way to start.",
 
@@ -0,0 +1,53 @@
+# Qt-free simulation core shared by the game and the headless tools.
+INCLUDEPATH += $$PWD
+CONFIG += thread
+
+SOURCES += \
+    $$PWD/batchsimulation.cpp \
+    $$PWD/blockprofile.cpp \
+    $$PWD/bytecode.cpp \
+    $$PWD/chunkedmap.cpp \
+    $$PWD/distancefield.cpp \
+    $$PWD/levelgenerator.cpp \
+    $$PWD/levelpack.cpp \
+    $$PWD/mappedfile.cpp \
+    $$PWD/multisimulation.cpp \
+    $$PWD/obstacleindex.cpp \
+    $$PWD/programverifier.cpp \
+    $$PWD/resultcache.cpp \
+    $$PWD/simulationcore.cpp \
+    $$PWD/simulationworker.cpp \
+    $$PWD/solver.cpp \
+    $$PWD/startsweep.cpp \
+    $$PWD/textformat.cpp \
+    $$PWD/threadpool.cpp \
+    $$PWD/tilegrid.cpp \
+    $$PWD/trace.cpp \
+    $$PWD/worldsimulation.cpp
+
+HEADERS += \
+    $$PWD/batchsimulation.h \
+    $$PWD/blockprofile.h \
+    $$PWD/bytecode.h \
+    $$PWD/byteorder.h \
+    $$PWD/chunkedmap.h \
+    $$PWD/constants.h \
+    $$PWD/cyclesearch.h \
+    $$PWD/distancefield.h \
+    $$PWD/levelgenerator.h \
+    $$PWD/levelpack.h \
+    $$PWD/mappedfile.h \
+    $$PWD/multisimulation.h \
+    $$PWD/obstacleindex.h \
+    $$PWD/programverifier.h \
+    $$PWD/resultcache.h \
+    $$PWD/simulationcore.h \
+    $$PWD/simulationworker.h \
+    $$PWD/solver.h \
+    $$PWD/startsweep.h \
+    $$PWD/textformat.h \
+    $$PWD/threadpool.h \
+    $$PWD/tilegrid.h \
+    $$PWD/trace.h \
+    $$PWD/worldsimulation.h \
+    $$PWD/zobrist.h
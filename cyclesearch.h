@@ -0,0 +1,89 @@
+/**
+ * @file cyclesearch.h
+ * @brief Finds where a run first repeats a state without remembering the
+ * states it reached.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef CYCLESEARCH_H
+#define CYCLESEARCH_H
+
+#include "constants.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+/// What looking ahead for a repeated state found out.
+struct RepeatSearch {
+    // Last tick looked at. No state repeats up to it except at repeatTick.
+    int knownUntil;
+    // Tick the first repeated state is reached on, -1 if none up to
+    // knownUntil.
+    int repeatTick;
+};
+
+/**
+ * @brief lookAheadTick Get how far a step that got past what was looked at
+ * looks ahead next, twice its tick so the looking adds up to a few times the
+ * run.
+ * @param tick
+ * @return
+ */
+inline int lookAheadTick(int tick) {
+    return (int)std::min(std::max(2LL * tick, 1024LL), (long long)INT_MAX);
+}
+
+/**
+ * @brief findRepeat Run a copy of a simulation on with Brent's cycle
+ * detection: each state is compared with one saved state, and a new one is
+ * saved whenever the distance to it reaches a power of two. A run first
+ * repeating a state at tick r is caught by tick 3r, after which two copies a
+ * period apart find r itself. Only three copies of the simulation are kept.
+ * The simulation needs advance(), which steps without checking for repeats,
+ * and getStateHash().
+ * @param start The run as it was before its first step.
+ * @param tick Look at least this far.
+ * @return
+ */
+template <class Simulation>
+RepeatSearch findRepeat(const Simulation &start, int tick) {
+    long long until = std::min(3LL * tick, (long long)INT_MAX);
+    Simulation probe = start;
+    std::uint64_t saved = probe.getStateHash();
+    int savedTick = probe.getTickCount();
+    long long power = 1;
+    while (probe.getGameState() == notEnded && probe.getTickCount() < until) {
+        probe.advance();
+        if (probe.getGameState() != notEnded)
+            break;
+        if (probe.getStateHash() == saved) {
+            // States repeat from the first tick two copies a period apart
+            // agree on.
+            int period = probe.getTickCount() - savedTick;
+            Simulation trailing = start;
+            Simulation leading = start;
+            for (int i = 0; i < period; i++) {
+                leading.advance();
+            }
+            while (trailing.getStateHash() != leading.getStateHash()) {
+                trailing.advance();
+                leading.advance();
+            }
+            return RepeatSearch{leading.getTickCount(), leading.getTickCount()};
+        }
+        if (probe.getTickCount() - savedTick == power) {
+            saved = probe.getStateHash();
+            savedTick = probe.getTickCount();
+            power *= 2;
+        }
+    }
+    // A run that ends never repeats a state.
+    if (probe.getGameState() != notEnded)
+        return RepeatSearch{INT_MAX, -1};
+    return RepeatSearch{(int)(until / 3), -1};
+}
+
+#endif // CYCLESEARCH_H
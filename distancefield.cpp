@@ -0,0 +1,40 @@
+/**
+ * @file distancefield.cpp
+ * @brief Walking distances from every cell of a map to one target cell.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "distancefield.h"
+#include <vector>
+
+namespace {
+// Cells the robot can never walk through, whatever it pushes.
+const unsigned char tileImpassable = tileWall | tilePit | tileOutside;
+} // namespace
+
+DistanceField::DistanceField() {}
+
+DistanceField::DistanceField(const TileGrid &grid, int target) {
+    int size = grid.getStride() * (grid.getHeight() + 2);
+    distances.assign(size, -1);
+    if (target < 0 || target >= size || (grid.at(target) & tileImpassable))
+        return;
+
+    // The queue is every cell in the order it was reached.
+    std::vector<int> queue{target};
+    distances[target] = 0;
+    for (unsigned long long next = 0; next < queue.size(); next++) {
+        int cell = queue[next];
+        for (direction dir : {north, south, east, west}) {
+            int neighbour = cell + grid.offset(dir);
+            if (distances[neighbour] >= 0 ||
+                    (grid.at(neighbour) & tileImpassable))
+                continue;
+            distances[neighbour] = distances[cell] + 1;
+            queue.push_back(neighbour);
+        }
+    }
+}
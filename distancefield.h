@@ -0,0 +1,48 @@
+/**
+ * @file distancefield.h
+ * @brief Header file for distancefield.cpp, walking distances from every cell
+ * of a map to one target cell.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include "tilegrid.h"
+#include <vector>
+
+/// Breadth first distances to a target cell, usually the cheese. Walls, pits
+/// and the map edge never move, while a block may be pushed out of the way,
+/// so blocks count as walkable. The field is then a lower bound on the moves
+/// needed that holds whatever the robot pushes later, and never needs
+/// updating during a run.
+class DistanceField {
+private:
+    // Moves to the target per cell index, -1 where it cannot be reached.
+    std::vector<int> distances;
+
+public:
+    DistanceField();
+
+    /**
+   * @brief DistanceField Run the breadth first search out from the target.
+   * @param grid
+   * @param target Cell index of the target, -1 leaves every cell
+   * unreachable.
+   */
+    DistanceField(const TileGrid &grid, int target);
+
+    /**
+   * @brief at Get the fewest moves from a cell to the target.
+   * @param cell
+   * @return -1 if the target cannot be reached.
+   */
+    int at(int cell) const {
+        return cell < 0 || cell >= (int)distances.size() ? -1 : distances[cell];
+    }
+};
+
+#endif // DISTANCEFIELD_H
@@ -112,7 +112,6 @@ HEADERS += \
     Box2D/Dynamics/b2WorldCallbacks.h \
     Box2D/Rope/b2Rope.h \
     celebrationwindow.h \
-    constants.h \
     gamecanvas.h \
     gamewindow.h \
     levelselectwindow.h \
@@ -120,6 +119,8 @@ HEADERS += \
     simulation.h
     simulation.h
 
+include(core.pri)
+
 FORMS += \
     celebrationwindow.ui \
     gamewindow.ui \
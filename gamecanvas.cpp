@@ -15,17 +15,18 @@
 #include "qtimer.h"
 #include "simulation.h"
 #include <QMovie>
+#include <QPaintEvent>
 #include <QPainter>
 
-GameCanvas::GameCanvas(QWidget *parent, std::vector<std::vector<MapTile>> map)
-    : QWidget{parent}, map(map) {
-    this->setMinimumSize(QSize(1000, 2000));
-
-    // Store the initial map and set the map if restart the game
+GameCanvas::GameCanvas(QWidget *parent, LevelView map)
+    : QWidget{parent}, s(nullptr), worker(nullptr), shownTick(0),
+      skipping(false), finishing(false) {
+    // Keep the initial map to set the map if restart the game
     resetMap = map;
 
     // Varibles for drawing the map
     brickSize = 100;
+    setMap(map);
     interval = 1000;
     robotSize = 90;
     preDir = east;
@@ -64,14 +65,26 @@ GameCanvas::GameCanvas(QWidget *parent, std::vector<std::vector<MapTile>> map)
     connect(timer, &QTimer::timeout, this, &GameCanvas::step);
 }
 
-void GameCanvas::paintEvent(QPaintEvent * /* event */) {
+GameCanvas::~GameCanvas() {
+    // Wait for the worker, it must not outlive the canvas
+    delete worker;
+    delete s;
+}
+
+void GameCanvas::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
 
-    // Got through the map vector
-    for (unsigned long long y = 0; y < map.size(); y++) {
-        for (unsigned long long x = 0; x < map[y].size(); x++) {
+    // Only go through the tiles inside the region that needs repainting
+    QRect dirty = event->rect();
+    int firstX = qMax(0, dirty.left() / brickSize);
+    int firstY = qMax(0, dirty.top() / brickSize);
+    int lastX = qMax(0, dirty.right() / brickSize);
+    int lastY = qMax(0, dirty.bottom() / brickSize);
+    for (int y = firstY; y < map.getHeight() && y <= lastY; y++) {
+        for (int x = firstX; x < map.getWidth() && x <= lastX; x++) {
+            MapTile tile = (MapTile)map.at(x, y);
             // Draw the robot
-            if (map[y][x] == start) {
+            if (tile == start) {
                 painter.fillRect(x * brickSize, y * brickSize, brickSize, brickSize,
                                  groundColor);
                 QPoint pos;
@@ -81,7 +94,7 @@ void GameCanvas::paintEvent(QPaintEvent * /* event */) {
                 emit showRobot(pos, robotSize);
             }
             // Draw the cheese
-            if (map[y][x] == cheese) {
+            if (tile == cheese) {
                 painter.fillRect(x * brickSize, y * brickSize, brickSize, brickSize,
                                  groundColor);
                 QPoint pos;
@@ -90,22 +103,22 @@ void GameCanvas::paintEvent(QPaintEvent * /* event */) {
                 emit showCheese(pos, robotSize);
             }
             // Draw the gournd
-            if (map[y][x] == ground) {
+            if (tile == ground) {
                 painter.fillRect(x * brickSize, y * brickSize, brickSize, brickSize,
                                  groundColor);
             }
             // Draw the pit
-            if (map[y][x] == pit) {
+            if (tile == pit) {
                 painter.fillRect(x * brickSize, y * brickSize, brickSize, brickSize,
                                  scaledPitMap);
             }
             // Draw the wall
-            if (map[y][x] == wall) {
+            if (tile == wall) {
                 painter.fillRect(x * brickSize, y * brickSize, brickSize, brickSize,
                                  scaledWallMap);
             }
             // Draw the block
-            if (map[y][x] == block) {
+            if (tile == block) {
                 painter.fillRect(x * brickSize, y * brickSize, brickSize, brickSize,
                                  scaledBlockMap);
             }
@@ -113,40 +126,170 @@ void GameCanvas::paintEvent(QPaintEvent * /* event */) {
     }
 }
 
-void GameCanvas::setMap(std::vector<std::vector<MapTile>> map) {
-    this->map = map;
+void GameCanvas::setMap(LevelView map) {
+    ChunkedMap tiles(map.getWidth(), map.getHeight(), ground, ground);
+    for (int y = 0; y < map.getHeight(); y++) {
+        for (int x = 0; x < map.getWidth(); x++) {
+            tiles.set(x, y, map.at(x, y));
+        }
+    }
+    setWorld(tiles);
+}
+
+void GameCanvas::setWorld(const ChunkedMap &world) {
+    map = world;
+    // Grow with the world, up to the largest size a widget can have
+    long long width = (long long)map.getWidth() * brickSize;
+    long long height = (long long)map.getHeight() * brickSize;
+    setMinimumSize(QSize((int)qBound(1000LL, width, (long long)QWIDGETSIZE_MAX),
+                         (int)qBound(2000LL, height, (long long)QWIDGETSIZE_MAX)));
     update();
 }
 
+void GameCanvas::applyChanges(const std::vector<TileChange> &changes) {
+    // Patch and repaint only the tiles that changed
+    for (const TileChange &change : changes) {
+        map.set(change.x, change.y, change.tile);
+        update(change.x * brickSize, change.y * brickSize, brickSize, brickSize);
+    }
+}
+
 void GameCanvas::simulate(std::vector<ProgramBlock> program) {
-    // Stop running the program
+    // Stop running the program, the old run is dropped without catching up
     stop();
-    s = new Simulation(map, program);
-    // Run the block
-    connect(s, &Simulation::runningBlock, this, &GameCanvas::emitRunningBlock);
+    delete worker;
+    delete s;
+    s = nullptr;
+    // The worker steps the run, the animation only shows it until a pause
+    // hands the run over
+    worker = new SimulationWorker(resetMap, program, FAST_FORWARD_MAX_STEPS);
+    shownTick = 0;
+    finishing = false;
+    // Show the level as the run sees it, the robot is drawn from the frames
+    // and later steps send deltas
+    setMap(resetMap);
+    for (int y = 0; y < resetMap.getHeight(); y++) {
+        for (int x = 0; x < resetMap.getWidth(); x++) {
+            if (resetMap.at(x, y) == start)
+                map.set(x, y, ground);
+        }
+    }
     emit restartGame();
-    run(interval);
+    if (skipping) {
+        finish();
+    } else {
+        run(interval);
+    }
 }
 
 void GameCanvas::step() {
+    SimulationFrame frame;
+    if (worker == nullptr || !worker->takeFrame(frame)) {
+        // The worker is behind, try again next tick unless it hit the step limit
+        if (worker == nullptr || worker->isDone()) {
+            stop();
+            emitProfile();
+        }
+        return;
+    }
+    // A skipped run ends on a frame with the whole map
+    if (!frame.map.empty())
+        setMap(frame.map);
+    shownTick = frame.tick;
+    emit currentBlock(frame.block);
+    if (showEnding(frame.state)) {
+        emitProfile();
+        return;
+    }
+    refreshRobot(QPoint(frame.robot.x, frame.robot.y), frame.robotDirection);
+    // Refresh the tiles that changed
+    applyChanges(frame.changes);
+}
+
+void GameCanvas::stepBackward() {
+    if (s == nullptr && worker == nullptr)
+        return;
+    pause();
+    if (!s->stepBack())
+        return;
+    refreshRobot(s->getRobotPos(), s->getRobotDirection());
+    // The map may show the reset map after a lost run, redraw the run's map
+    setMap(s->getMap());
+}
+
+void GameCanvas::stepForward() {
+    if (s == nullptr && worker == nullptr)
+        return;
+    pause();
+    if (s->getGameState() != notEnded)
+        return;
     s->step();
+    if (showEnding(s->getGameState()))
+        return;
+    refreshRobot(s->getRobotPos(), s->getRobotDirection());
+    applyChanges(s->getChanges());
+}
+
+bool GameCanvas::skipToResult() {
+    // Only a run that is still animating can be skipped
+    if (worker == nullptr || !timer->isActive())
+        return false;
+    finish();
+    return true;
+}
+
+void GameCanvas::setSkipping(bool skip) { skipping = skip; }
+
+void GameCanvas::finish() {
+    // The worker runs to the end on its own thread, the window stays
+    // responsive and only polls for the result
+    finishing = true;
+    worker->skip();
+    run(SKIP_POLL_INTERVAL);
+}
+
+void GameCanvas::pause() {
+    stop();
+    if (worker == nullptr)
+        return;
+    // Go on from the worker's run, it only undoes the frames not shown yet
+    s = new Simulation(worker->stop(shownTick));
+    connect(s, &Simulation::runningBlock, this, &GameCanvas::emitRunningBlock);
+    emit currentBlock(s->getCurrentBlock());
+    delete worker;
+    worker = nullptr;
+    finishing = false;
+}
+
+bool GameCanvas::showEnding(gameState state) {
     // lost in the game
-    if(s->getGameState() == lost){
+    if(state == lost){
         // reset the robot and map
         emit robotMovie(rightWaiting);
         setMap(resetMap);
         stop();
-        return;
+        return true;
+    }
+    // stuck in a loop that never ends
+    if(state == nonTerminating){
+        emit robotMovie(rightWaiting);
+        setMap(resetMap);
+        stop();
+        emit programLooping();
+        return true;
     }
-    if(s->getGameState() == won){
+    if(state == won){
         // tell the game window the user won
         emit gameWon();
         stop();
-        return;
+        return true;
     }
+    return false;
+}
+
+void GameCanvas::refreshRobot(QPoint pos, direction currentDir) {
     // Refresh the robot
-    emit showRobot(s->getRobotPos() * brickSize, robotSize);
-    direction currentDir = s->getRobotDirection();
+    emit showRobot(pos * brickSize, robotSize);
     // If the robot turn
     if (preDir != currentDir) {
         switch (currentDir) {
@@ -168,15 +311,20 @@ void GameCanvas::step() {
             break;
         }
     }
-    // Refresh the map
-    setMap(s->getMap());
+}
+
+void GameCanvas::emitProfile() {
+    BlockProfile profile;
+    if (worker != nullptr && worker->getProfile(profile))
+        emit runProfiled(profile);
 }
 
 void GameCanvas::run(int newInterval) { timer->start(newInterval); }
 
 void GameCanvas::setInterval(int newInterval){
     interval = newInterval;
-    if(timer->isActive()){
+    // A skipped run keeps polling for its result
+    if(timer->isActive() && !finishing){
         timer->setInterval(interval);
     }
 }
@@ -14,6 +14,8 @@
 #define GAMECANVAS_H
 
 #include "simulation.h"
+#include "simulationworker.h"
+#include "chunkedmap.h"
 #include "constants.h"
 #include "qmovie.h"
 #include <QWidget>
@@ -25,11 +27,25 @@ class GameCanvas : public QWidget {
     QPainter painter;
 
 public:
-    explicit GameCanvas(QWidget* parent, std::vector<std::vector<MapTile>> map);
+    explicit GameCanvas(QWidget* parent, LevelView map);
+    ~GameCanvas();
 
 private:
-    // a simulation to control the robot moving
+    // the run stepped by hand once paused, nullptr while the worker has it
     Simulation *s;
+    // runs the program ahead of the animation, the timer only shows its frames
+    SimulationWorker *worker;
+    // tick of the last frame shown
+    int shownTick;
+
+    // steps allowed when skipping to the result of a run
+    static constexpr int FAST_FORWARD_MAX_STEPS = 1000000;
+    // whether the next simulation skips straight to its result
+    bool skipping;
+    // how often the timer looks for the result of a skipped run
+    static constexpr int SKIP_POLL_INTERVAL = 15;
+    // whether the worker finishes the run without frames and the timer waits for its last one
+    bool finishing;
 
     // varibles for drawing the map
     QPixmap scaledWallMap;
@@ -56,9 +72,10 @@ private:
     // cheese icon
     QPixmap scaledCheeseMap;
 
-    // current map
-    std::vector<std::vector<MapTile>> map;
-    std::vector<std::vector<MapTile>> resetMap;
+    // current map, one MapTile per tile
+    ChunkedMap map;
+    // the level as it starts, viewed rather than copied
+    LevelView resetMap;
 
     // size of map blocks
     int brickSize;
@@ -68,16 +85,44 @@ public slots:
      * @brief setMap Draw the map on the canvas
      * @param map
      */
-    void setMap(std::vector<std::vector<MapTile>> map);
+    void setMap(LevelView map);
+    /**
+     * @brief setWorld Draw a world of MapTile values, only the tiles in view are read
+     * @param world
+     */
+    void setWorld(const ChunkedMap &world);
+    /**
+     * @brief applyChanges Patch the tiles changed by the last step and repaint only them
+     * @param changes
+     */
+    void applyChanges(const std::vector<TileChange> &changes);
     /**
      * @brief simulate Create a simulation by using the user's program and current map
      * @param program
      */
     void simulate(std::vector<ProgramBlock> program);
     /**
-     * @brief step Get next step from simulation
+     * @brief step Show the next frame from the worker
      */
     void step();
+    /**
+     * @brief stepBackward Pause the run and undo its last step
+     */
+    void stepBackward();
+    /**
+     * @brief stepForward Pause the run and execute one step
+     */
+    void stepForward();
+    /**
+     * @brief skipToResult Finish the animating run without drawing every step
+     * @return false if no run is animating
+     */
+    bool skipToResult();
+    /**
+     * @brief setSkipping Make the next simulation skip straight to its result
+     * @param skip
+     */
+    void setSkipping(bool skip);
     /**
      * @brief run Start the timer for run the progame
      * @param interval Interval of the timer
@@ -98,6 +143,32 @@ public slots:
      */
     void emitRunningBlock(int block);
 
+private:
+    /**
+     * @brief finish Have the worker run to the end and show only its result
+     */
+    void finish();
+    /**
+     * @brief pause Stop the worker and step by hand from the run it hands over
+     */
+    void pause();
+    /**
+     * @brief showEnding Handle a won, lost or looping game
+     * @param state
+     * @return true if the game ended
+     */
+    bool showEnding(gameState state);
+    /**
+     * @brief refreshRobot Move the robot and turn its movie to its direction
+     * @param pos Robot tile
+     * @param currentDir
+     */
+    void refreshRobot(QPoint pos, direction currentDir);
+    /**
+     * @brief emitProfile Send the profile of the run once the worker finished it
+     */
+    void emitProfile();
+
 protected:
     /**
      * @brief paintEvent Paint the whole map on the canvas
@@ -126,6 +197,11 @@ signals:
      */
     void gameWon();
 
+    /**
+     * @brief programLooping Send the signal to game window if the program would never end
+     */
+    void programLooping();
+
     /**
      * @brief restartGame Send the signal to the simulation if restart the game
      */
@@ -135,6 +211,11 @@ signals:
      * @brief currentBlock Send the current program block to the simulation
      */
     void currentBlock(int);
+
+    /**
+     * @brief runProfiled Send the step counts of a finished run to the editor
+     */
+    void runProfiled(const BlockProfile &);
 };
 
 #endif // GAMECANVAS_H
@@ -22,7 +22,7 @@
 #include <QSlider>
 #include <QTimer>
 
-GameWindow::GameWindow(std::vector<std::vector<MapTile>> map, int levelNumber,
+GameWindow::GameWindow(LevelView map, int levelNumber,
                        QMainWindow *parent)
     : QMainWindow(parent), ui(new Ui::GameWindow), levelNumber(levelNumber) {
     ui->setupUi(this);
@@ -36,6 +36,7 @@ GameWindow::GameWindow(std::vector<std::vector<MapTile>> map, int levelNumber,
     connect(canvas, &GameCanvas::showCheese, this, &GameWindow::showCheese);
     connect(canvas, &GameCanvas::restartGame, this, &GameWindow::restart);
     connect(canvas, &GameCanvas::gameWon, this, &GameWindow::gameWon);
+    connect(canvas, &GameCanvas::programLooping, this, &GameWindow::stuck);
     // show the level number and welcome to the user
     QString num = QString::number(levelNumber + 1);
     QString welcome = "Welcome!";
@@ -57,7 +58,7 @@ GameWindow::GameWindow(std::vector<std::vector<MapTile>> map, int levelNumber,
     QTimer::singleShot(200, this, &GameWindow::showEducationalMessage);
 
     // Connects program pannel.
-    MachineGraph *graph = new MachineGraph();
+    graph = new MachineGraph();
     ui->mainLayout->insertWidget(0, graph);
     connect(ui->connectButton, &QPushButton::clicked, graph,
             &MachineGraph::toggleConnecting);
@@ -94,12 +95,21 @@ GameWindow::GameWindow(std::vector<std::vector<MapTile>> map, int levelNumber,
 
     connect(ui->getOutput, &QPushButton::clicked, graph,
             &MachineGraph::getProgram);
+    connect(ui->skipButton, &QPushButton::clicked, this,
+            &GameWindow::skipButtonPushed);
+    connect(ui->stepBackButton, &QPushButton::clicked, canvas,
+            &GameCanvas::stepBackward);
+    connect(ui->stepForwardButton, &QPushButton::clicked, canvas,
+            &GameCanvas::stepForward);
 
     // Get program from the graph and send it to the game window
     connect(graph, &MachineGraph::programData, canvas, &GameCanvas::simulate);
     connect(this, &GameWindow::changeType, graph, &MachineGraph::setType);
     connect(canvas, &GameCanvas::currentBlock, graph,
             &MachineGraph::setRunningBlock);
+    // Color the editor by where the finished run spent its steps
+    connect(canvas, &GameCanvas::runProfiled, graph,
+            &MachineGraph::setProfile);
 
     connect(ui->speedSlider, &QSlider::valueChanged, canvas,
             &GameCanvas::setInterval);
@@ -135,7 +145,7 @@ void GameWindow::showRobotMovie(QMovie *theMovie) {
     theMovie->start();
 }
 
-void GameWindow::changeMap(std::vector<std::vector<MapTile>> map) {
+void GameWindow::changeMap(LevelView map) {
     // show the map on canvas
     auto canvas = new GameCanvas(ui->scrollAreaWidgetContents, map);
 
@@ -151,8 +161,11 @@ void GameWindow::gameStartTest() {}
 void GameWindow::runningTest() {}
 
 void GameWindow::showEducationalMessage() {
-    QMessageBox::information(this, "About This Level",
-                             educationalMessages[levelNumber]);
+    // Levels from a level pack come without a message of their own.
+    const char *message = levelNumber < builtInLevelCount
+            ? educationalMessages[levelNumber]
+            : "Program the robot to reach the cheese and eat it!";
+    QMessageBox::information(this, "About This Level", message);
 }
 
 void GameWindow::lost() {
@@ -162,6 +175,11 @@ void GameWindow::lost() {
     showIdleRobot(respawn, 90);
 }
 
+void GameWindow::stuck() {
+    QString stuck = "Your robot is stuck in a loop, try again!";
+    ui->welcomeLabel->setText(stuck);
+}
+
 void GameWindow::restart() {
     QString restart = "Welcome!";
     ui->welcomeLabel->setText(restart);
@@ -209,6 +227,15 @@ void GameWindow::facingCheeseButtonPushed() {
     emit changeType(ProgramBlock::conditionFacingCheese);
 }
 
+void GameWindow::skipButtonPushed() {
+    if (canvas->skipToResult())
+        return;
+    // getProgram hands the program to the canvas before it returns
+    canvas->setSkipping(true);
+    graph->getProgram();
+    canvas->setSkipping(false);
+}
+
 void GameWindow::connectToggled(bool connecting) {
     if (connecting) {
         ui->connectButton->setStyleSheet("background-color: rgb(255, 0, 0);font: "
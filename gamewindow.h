@@ -14,6 +14,7 @@
 
 #include "constants.h"
 #include "gamecanvas.h"
+#include "machinegraph.h"
 
 #include <QMainWindow>
 #include <QTimer>
@@ -26,7 +27,14 @@ class GameWindow : public QMainWindow {
     Q_OBJECT
 
 public:
-    explicit GameWindow(std::vector<std::vector<MapTile>> map, int levelNumber,
+    /**
+   * @brief GameWindow Show a level. The window only views the level's tiles,
+   * so they must outlive it.
+   * @param map
+   * @param levelNumber
+   * @param parent
+   */
+    explicit GameWindow(LevelView map, int levelNumber,
                         QMainWindow *parent = nullptr);
     ~GameWindow();
 
@@ -37,12 +45,13 @@ private:
     int levelNumber;
 
     GameCanvas *canvas;
+    MachineGraph *graph;
 
 private slots:
     /**
    * @brief changeMap Change the map in the new level
    */
-    void changeMap(std::vector<std::vector<MapTile>>);
+    void changeMap(LevelView);
 
     /**
    * @brief gameStartTest Test for the elements display
@@ -79,6 +88,11 @@ private slots:
    */
     void lost();
 
+    /**
+   * @brief stuck Tell the user the program loops forever
+   */
+    void stuck();
+
     /**
    * @brief restart When the user creat a new program and try again
    */
@@ -106,6 +120,12 @@ private slots:
     void facingBlockButtonPushed();
     void facingCheeseButtonPushed();
 
+    /**
+   * @brief skipButtonPushed Skip the animating run to its result, or run the
+   * program straight to its result if nothing is animating.
+   */
+    void skipButtonPushed();
+
     /**
    * @brief connectToggled Toggle the connection mode.
    * @param connecting
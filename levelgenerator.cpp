@@ -0,0 +1,355 @@
+/**
+ * @file levelgenerator.cpp
+ * @brief Random maze levels with blocks and pits that are checked to be
+ * solvable.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "levelgenerator.h"
+#include "threadpool.h"
+#include "tilegrid.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// Cells the robot can never walk into.
+const unsigned char tileImpassable = tileWall | tilePit | tileOutside;
+
+// Cells a block can never be pushed into. A pit swallows the block.
+const unsigned char tileStopsBlock = tileWall | tileOutside;
+
+/// A layout is the robot cell followed by every block cell in increasing
+/// order, two bytes each. Short layouts fit in the string's own buffer.
+std::string layoutKey(int robot, const std::vector<int> &blocks) {
+    std::string key;
+    key.reserve(2 * (blocks.size() + 1));
+    key += (char)(robot & 0xff);
+    key += (char)(robot >> 8);
+    for (int cell : blocks) {
+        key += (char)(cell & 0xff);
+        key += (char)(cell >> 8);
+    }
+    return key;
+}
+
+void readLayout(const std::string &key, int &robot, std::vector<int> &blocks) {
+    auto cellAt = [&key](unsigned long long i) {
+        return (unsigned char)key[i] | (unsigned char)key[i + 1] << 8;
+    };
+    robot = cellAt(0);
+    blocks.clear();
+    for (unsigned long long i = 2; i < key.size(); i += 2) {
+        blocks.push_back(cellAt(i));
+    }
+}
+
+int randomBelow(std::mt19937_64 &random, int bound) {
+    return (int)(random() % (unsigned long long)bound);
+}
+
+} // namespace
+
+LevelCheck checkLevel(const std::vector<std::vector<MapTile>> &level,
+                      int maxStates) {
+    LevelCheck check{false, 0, 0, false};
+    TileGrid grid(level);
+    int robot = -1;
+    int target = -1;
+    std::vector<int> blocks;
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (level[y][x] == start)
+                robot = grid.index(x, y);
+            else if (level[y][x] == cheese)
+                target = grid.index(x, y);
+            else if (level[y][x] == block)
+                blocks.push_back(grid.index(x, y));
+        }
+    }
+    int size = grid.getStride() * (grid.getHeight() + 2);
+    // Layout keys hold two bytes per cell.
+    if (robot < 0 || target < 0 || size > 0x10000)
+        return check;
+
+    // Cells marked with the number of the layout being expanded, so the
+    // buffers never need clearing.
+    std::vector<int> blockMark(size, -1);
+    std::vector<int> reachMark(size, -1);
+    std::vector<int> reached;
+    std::vector<int> moved;
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> frontier{layoutKey(robot, blocks)};
+    std::vector<std::string> next;
+    int stamp = 0;
+
+    // Each round expands every layout that needs one more push than the last.
+    for (int pushes = 0; !frontier.empty(); pushes++) {
+        next.clear();
+        for (const std::string &key : frontier) {
+            readLayout(key, robot, blocks);
+            stamp++;
+            for (int cell : blocks) {
+                blockMark[cell] = stamp;
+            }
+
+            // Every cell the robot walks to without pushing.
+            reached.assign(1, robot);
+            reachMark[robot] = stamp;
+            int corner = robot;
+            for (unsigned long long i = 0; i < reached.size(); i++) {
+                int cell = reached[i];
+                corner = std::min(corner, cell);
+                for (direction dir : {north, south, east, west}) {
+                    int neighbour = cell + grid.offset(dir);
+                    if (reachMark[neighbour] == stamp ||
+                            blockMark[neighbour] == stamp ||
+                            (grid.at(neighbour) & tileImpassable))
+                        continue;
+                    reachMark[neighbour] = stamp;
+                    reached.push_back(neighbour);
+                }
+            }
+            if (reachMark[target] == stamp) {
+                check.solvable = true;
+                check.pushes = pushes;
+                return check;
+            }
+
+            // Layouts that differ only in where the robot stands inside the
+            // same walkable area are one layout.
+            if (!seen.insert(layoutKey(corner, blocks)).second)
+                continue;
+            if (++check.states > maxStates) {
+                check.exhausted = true;
+                return check;
+            }
+
+            for (int cell : reached) {
+                for (direction dir : {north, south, east, west}) {
+                    int box = cell + grid.offset(dir);
+                    if (blockMark[box] != stamp)
+                        continue;
+                    int behind = box + grid.offset(dir);
+                    if (blockMark[behind] == stamp ||
+                            (grid.at(behind) & tileStopsBlock))
+                        continue;
+                    moved.clear();
+                    for (int other : blocks) {
+                        if (other != box)
+                            moved.push_back(other);
+                    }
+                    if (!(grid.at(behind) & tilePit)) {
+                        moved.insert(std::lower_bound(moved.begin(),
+                                                      moved.end(), behind),
+                                     behind);
+                    }
+                    next.push_back(layoutKey(box, moved));
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    return check;
+}
+
+std::vector<std::vector<MapTile>> generateCandidate(int difficulty,
+                                                    std::uint64_t seed) {
+    difficulty = std::max(1, std::min(10, difficulty));
+    std::mt19937_64 random(seed);
+
+    // Rooms sit on even coordinates, the cells between them are walls until
+    // a passage is carved through.
+    int rooms = 3 + (difficulty + 1) / 2;
+    int size = 2 * rooms - 1;
+    std::vector<std::vector<MapTile>> level(size,
+                                            std::vector<MapTile>(size, wall));
+    const int stepX[] = {0, 0, 2, -2};
+    const int stepY[] = {-2, 2, 0, 0};
+
+    // Depth first maze: carve from the newest room with unvisited neighbours.
+    std::vector<int> stack{0};
+    level[0][0] = ground;
+    while (!stack.empty()) {
+        int x = stack.back() % size;
+        int y = stack.back() / size;
+        int open[4];
+        int openCount = 0;
+        for (int dir = 0; dir < 4; dir++) {
+            int nx = x + stepX[dir];
+            int ny = y + stepY[dir];
+            if (nx >= 0 && ny >= 0 && nx < size && ny < size &&
+                    level[ny][nx] == wall)
+                open[openCount++] = dir;
+        }
+        if (openCount == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int dir = open[randomBelow(random, openCount)];
+        level[y + stepY[dir] / 2][x + stepX[dir] / 2] = ground;
+        level[y + stepY[dir]][x + stepX[dir]] = ground;
+        stack.push_back((y + stepY[dir]) * size + x + stepX[dir]);
+    }
+
+    // Knock out extra walls between rooms, so blocks have room to be pushed
+    // aside and the maze has loops.
+    for (int i = 0; i < rooms * rooms / 3; i++) {
+        int x = randomBelow(random, size);
+        int y = randomBelow(random, size);
+        if ((x + y) % 2 == 1)
+            level[y][x] = ground;
+    }
+
+    // Open a few pillars between four rooms into small halls.
+    for (int i = 0; i < difficulty; i++) {
+        int x = 2 * randomBelow(random, rooms - 1) + 1;
+        int y = 2 * randomBelow(random, rooms - 1) + 1;
+        level[y][x] = ground;
+    }
+
+    // Work backwards from the won position: the robot stands on the cheese
+    // and walks away from it, pulling any block it backs away from. Undoing
+    // the walk pushes every block back, so the level is always winnable.
+    int x = 2 * randomBelow(random, rooms);
+    int y = 2 * randomBelow(random, rooms);
+    int cheeseX = x;
+    int cheeseY = y;
+    for (int i = 0; i <= difficulty; i++) {
+        int blockX = randomBelow(random, size);
+        int blockY = randomBelow(random, size);
+        if (level[blockY][blockX] == ground &&
+                (blockX != cheeseX || blockY != cheeseY))
+            level[blockY][blockX] = block;
+    }
+
+    const int moveX[] = {0, 0, 1, -1};
+    const int moveY[] = {-1, 1, 0, 0};
+    auto inside = [size](int cellX, int cellY) {
+        return cellX >= 0 && cellY >= 0 && cellX < size && cellY < size;
+    };
+    auto free = [&](int cellX, int cellY) {
+        return inside(cellX, cellY) && level[cellY][cellX] == ground;
+    };
+    auto pulls = [&](int dir) {
+        return free(x + moveX[dir], y + moveY[dir]) &&
+                inside(x - moveX[dir], y - moveY[dir]) &&
+                level[y - moveY[dir]][x - moveX[dir]] == block &&
+                (x != cheeseX || y != cheeseY);
+    };
+    // Cells the walk crossed, pits may only go elsewhere.
+    std::vector<std::vector<bool>> visited(size, std::vector<bool>(size, false));
+    visited[y][x] = true;
+    // The walk goes on past its length until it leaves the cheese.
+    int steps = 12 * rooms * difficulty;
+    for (int i = 0; i < steps || (i < 2 * steps && x == cheeseX && y == cheeseY);
+         i++) {
+        // Mostly take a step that pulls a block when there is one, pulls
+        // are what the player has to undo.
+        int dir = randomBelow(random, 4);
+        if (randomBelow(random, 4) != 0) {
+            for (int turn = 0; turn < 4; turn++) {
+                if (pulls((dir + turn) % 4)) {
+                    dir = (dir + turn) % 4;
+                    break;
+                }
+            }
+        }
+        if (!free(x + moveX[dir], y + moveY[dir]))
+            continue;
+        if (pulls(dir)) {
+            level[y - moveY[dir]][x - moveX[dir]] = ground;
+            level[y][x] = block;
+        }
+        x += moveX[dir];
+        y += moveY[dir];
+        visited[y][x] = true;
+    }
+    // Blocks all around the cheese leave the walk nowhere to go. Clear one
+    // and start beside the cheese rather than on it.
+    for (int dir = 0; dir < 4 && x == cheeseX && y == cheeseY; dir++) {
+        if (inside(x + moveX[dir], y + moveY[dir]) &&
+                level[y + moveY[dir]][x + moveX[dir]] == block) {
+            x += moveX[dir];
+            y += moveY[dir];
+            level[y][x] = ground;
+            visited[y][x] = true;
+        }
+    }
+    level[cheeseY][cheeseX] = cheese;
+    level[y][x] = start;
+
+    for (int i = 0; i < difficulty / 2 + 1; i++) {
+        int pitX = randomBelow(random, size);
+        int pitY = randomBelow(random, size);
+        if (level[pitY][pitX] == ground && !visited[pitY][pitX])
+            level[pitY][pitX] = pit;
+    }
+    return level;
+}
+
+GeneratorResult generateLevels(const GeneratorOptions &options) {
+    GeneratorResult result{{}, 0};
+    WorkStealingPool pool(options.threads);
+    long long batch = 32LL * pool.getThreadCount();
+    std::vector<GeneratedLevel> found(batch);
+    std::vector<char> accepted(batch);
+
+    for (long long first = 0; (int)result.levels.size() < options.count &&
+            first < options.maxCandidates; first += batch) {
+        for (long long i = 0; i < batch; i++) {
+            pool.submit([&options, &found, &accepted, first, i]() {
+                std::uint64_t seed = mixHash(options.seed ^ mixHash(first + i));
+                GeneratedLevel &level = found[i];
+                level.level = generateCandidate(options.difficulty, seed);
+                level.seed = seed;
+                level.check = checkLevel(level.level, options.maxStates);
+                accepted[i] = level.check.solvable &&
+                        level.check.pushes >= (options.difficulty + 1) / 2;
+            });
+        }
+        pool.wait();
+
+        // Keep candidate order so the thread count never changes the output.
+        for (long long i = 0; i < batch && first + i < options.maxCandidates &&
+                (int)result.levels.size() < options.count; i++) {
+            result.candidates++;
+            if (accepted[i])
+                result.levels.push_back(found[i]);
+        }
+    }
+    return result;
+}
+
+ChunkGenerator worldGenerator(int difficulty, std::uint64_t seed) {
+    difficulty = std::max(1, std::min(10, difficulty));
+    return [difficulty, seed](int chunkX, int chunkY,
+                              std::vector<unsigned char> &tiles) {
+        std::mt19937_64 random(mixHash(
+                seed ^ mixHash((std::uint64_t)(std::uint32_t)chunkY << 32 |
+                               (std::uint32_t)chunkX)));
+        // Out of every thousand tiles.
+        int walls = 20 * difficulty;
+        int blocks = walls + 5 * difficulty;
+        int pits = blocks + 2 * difficulty;
+        for (unsigned char &tile : tiles) {
+            int roll = randomBelow(random, 1000);
+            if (roll < walls) {
+                tile = tileWall;
+            } else if (roll < blocks) {
+                tile = tileBlock;
+            } else if (roll < pits) {
+                tile = tilePit;
+            } else if (roll == pits) {
+                tile = tileCheese;
+            }
+        }
+    };
+}
@@ -0,0 +1,113 @@
+/**
+ * @file levelgenerator.h
+ * @brief Header file for levelgenerator.cpp, random maze levels with blocks
+ * and pits that are checked to be solvable.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include "chunkedmap.h"
+#include "constants.h"
+#include <cstdint>
+#include <vector>
+
+/// Outcome of checking whether a level can be won.
+struct LevelCheck {
+    bool solvable;
+    // Fewest block pushes needed to reach the cheese, valid when solvable.
+    int pushes;
+    // Block layouts the search looked at.
+    int states;
+    // Whether the search stopped at its state limit before deciding.
+    bool exhausted;
+};
+
+/// Limits for a generator run.
+struct GeneratorOptions {
+    // 1 to 10, sets the maze size and the number of blocks and pits. An
+    // accepted level needs at least (difficulty + 1) / 2 pushes.
+    int difficulty = 3;
+    // Levels to produce.
+    int count = 100;
+    std::uint64_t seed = 1;
+    // Worker threads, 0 picks one per hardware thread.
+    int threads = 0;
+    // Block layouts a check may look at before the candidate is dropped.
+    int maxStates = 100000;
+    // Candidates drawn at most, in case the difficulty is never reached.
+    long long maxCandidates = 1000000;
+};
+
+/// A level that passed the check.
+struct GeneratedLevel {
+    std::vector<std::vector<MapTile>> level;
+    // Seed that makes generateCandidate draw this level again.
+    std::uint64_t seed;
+    LevelCheck check;
+};
+
+/// Totals of a generator run.
+struct GeneratorResult {
+    std::vector<GeneratedLevel> levels;
+    // Candidates drawn, accepted or not.
+    long long candidates;
+};
+
+/**
+ * @brief checkLevel Decide whether the robot can reach the cheese, pushing
+ * blocks under the same rules as SimulationCore: a block moves when the cell
+ * behind it is free, falls into a pit behind it, and stops the robot
+ * otherwise. Walking into a pit loses. A program can turn and move freely,
+ * so a level is winnable exactly when such a path exists. The search is
+ * breadth first over block layouts, with the robot standing for every cell
+ * it can walk to without pushing, so it finds the fewest pushes.
+ * @param level A level with one start and one cheese tile.
+ * @param maxStates Layouts to look at before giving up.
+ * @return
+ */
+LevelCheck checkLevel(const std::vector<std::vector<MapTile>> &level,
+                      int maxStates);
+
+/**
+ * @brief generateCandidate Draw a random maze with loops and scatter blocks
+ * over it, then work backwards from a won game: the robot stands on the
+ * cheese in a random room and walks away at random, mostly pulling a block
+ * it backs away from. The robot starts where the walk ends, and undoing the
+ * walk pushes every pulled block back. Pits only go on cells the walk never
+ * crossed. The candidate is not checked.
+ * @param difficulty 1 to 10.
+ * @param seed The same seed always draws the same level.
+ * @return
+ */
+std::vector<std::vector<MapTile>> generateCandidate(int difficulty,
+                                                    std::uint64_t seed);
+
+/**
+ * @brief generateLevels Draw candidates on a work-stealing thread pool, one
+ * candidate per task and each checked on its own thread, and keep those that
+ * are solvable and need enough pushes for the difficulty. Candidates
+ * are drawn in numbered batches and kept in candidate order, so the result
+ * only depends on the options, never on the thread count.
+ * @param options
+ * @return
+ */
+GeneratorResult generateLevels(const GeneratorOptions &options);
+
+/**
+ * @brief worldGenerator Scatter walls, blocks, pits and the odd cheese over a
+ * world of TileGrid class bits, for WorldSimulation. Every chunk is drawn
+ * from the seed and its own coordinates, so chunks can be made in any order
+ * and a world comes out the same however much of it was looked at. Worlds
+ * are not checked to be winnable.
+ * @param difficulty 1 to 10, more walls, blocks and pits.
+ * @param seed
+ * @return
+ */
+ChunkGenerator worldGenerator(int difficulty, std::uint64_t seed);
+
+#endif // LEVELGENERATOR_H
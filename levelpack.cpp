@@ -0,0 +1,164 @@
+/**
+ * @file levelpack.cpp
+ * @brief Binary files holding many levels that are decoded one at a time.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "levelpack.h"
+#include "byteorder.h"
+#include "textformat.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// File layout, all integers little endian:
+//   header    "ECLP", version u32, level count u32
+//   index     per level: tile offset u64, width u32, height u32
+//   tiles     per level: width * height MapTile values in reading order,
+//             four bits each, two to a byte with the first in the low bits
+namespace {
+
+const char packMagic[] = "ECLP";
+const std::uint32_t packVersion = 1;
+const int headerSize = 12;
+const int indexEntrySize = 16;
+
+} // namespace
+
+LevelPack::LevelPack() : levelCount(0) {}
+
+bool LevelPack::open(const std::string &path, std::string &error) {
+    levelCount = 0;
+    if (!file.open(path)) {
+        error = "cannot read " + path;
+        return false;
+    }
+    const unsigned char *data = file.getData();
+    std::uint64_t size = file.getSize();
+    if (size < (std::uint64_t)headerSize ||
+            std::memcmp(data, packMagic, 4) != 0) {
+        file.close();
+        error = path + " is not a level pack";
+        return false;
+    }
+    if (get32(data + 4) != packVersion) {
+        file.close();
+        error = path + " was written by another version";
+        return false;
+    }
+    std::uint64_t count = get32(data + 8);
+    if (count * indexEntrySize > size - headerSize) {
+        file.close();
+        error = path + " is truncated";
+        return false;
+    }
+    levelCount = count;
+    return true;
+}
+
+bool LevelPack::level(int index,
+                      std::vector<std::vector<MapTile>> &level) const {
+    if (index < 0 || index >= levelCount)
+        return false;
+    const unsigned char *data = file.getData();
+    const unsigned char *entry = data + headerSize +
+            (std::uint64_t)index * indexEntrySize;
+    std::uint64_t offset = get64(entry);
+    std::uint64_t width = get32(entry + 8);
+    std::uint64_t height = get32(entry + 12);
+    std::uint64_t bytes = (width * height + 1) / 2;
+    if (width == 0 || height == 0 || offset > file.getSize() ||
+            bytes > file.getSize() - offset)
+        return false;
+
+    const unsigned char *tiles = data + offset;
+    std::vector<std::vector<MapTile>> decoded(height,
+                                              std::vector<MapTile>(width));
+    std::uint64_t i = 0;
+    for (std::vector<MapTile> &row : decoded) {
+        for (MapTile &tile : row) {
+            unsigned value = (tiles[i / 2] >> (i % 2 * 4)) & 0xf;
+            if (value > pit)
+                return false;
+            tile = (MapTile)value;
+            i++;
+        }
+    }
+    level.swap(decoded);
+    return true;
+}
+
+bool saveLevelPack(const std::string &path,
+                   const std::vector<std::vector<std::vector<MapTile>>> &levels) {
+    std::vector<unsigned char> index;
+    std::vector<unsigned char> tiles;
+    index.insert(index.end(), packMagic, packMagic + 4);
+    put32(index, packVersion);
+    put32(index, levels.size());
+    std::uint64_t tileStart = headerSize + levels.size() * indexEntrySize;
+    for (const std::vector<std::vector<MapTile>> &level : levels) {
+        put64(index, tileStart + tiles.size());
+        put32(index, level.empty() ? 0 : level[0].size());
+        put32(index, level.size());
+        bool low = true;
+        for (const std::vector<MapTile> &row : level) {
+            for (MapTile tile : row) {
+                if (low) {
+                    tiles.push_back(tile & 0xf);
+                } else {
+                    tiles.back() |= (tile & 0xf) << 4;
+                }
+                low = !low;
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file.write((const char *)index.data(), index.size());
+    file.write((const char *)tiles.data(), tiles.size());
+    return (bool)file;
+}
+
+bool loadLevel(const std::string &argument,
+               std::vector<std::vector<MapTile>> &level, std::string &error) {
+    char *end = nullptr;
+    long number = std::strtol(argument.c_str(), &end, 10);
+    if (!argument.empty() && *end == '\0') {
+        if (number < 1 || number > builtInLevelCount) {
+            error = "no built-in level " + argument;
+            return false;
+        }
+        level = levels[number - 1].toVector();
+        return true;
+    }
+    // "levels.pack:3" is the third level of a level pack.
+    std::string::size_type colon = argument.rfind(':');
+    if (colon != std::string::npos) {
+        number = std::strtol(argument.c_str() + colon + 1, &end, 10);
+        if (colon + 1 < argument.size() && *end == '\0') {
+            LevelPack pack;
+            if (!pack.open(argument.substr(0, colon), error))
+                return false;
+            // Checked as a long, so a number past int cannot wrap around.
+            if (number < 1 || number > pack.getLevelCount() ||
+                    !pack.level((int)(number - 1), level)) {
+                error = "no level " + argument;
+                return false;
+            }
+            return true;
+        }
+    }
+    std::string text;
+    if (!readFile(argument, text)) {
+        error = "cannot read " + argument;
+        return false;
+    }
+    return parseLevel(text, level, error);
+}
@@ -0,0 +1,77 @@
+/**
+ * @file levelpack.h
+ * @brief Header file for levelpack.cpp, binary files holding many levels that
+ * are decoded one at a time.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef LEVELPACK_H
+#define LEVELPACK_H
+
+#include "constants.h"
+#include "mappedfile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Reads a level pack through a memory map. Opening only checks the header,
+/// so a pack with thousands of levels opens instantly; a level's tiles are
+/// read and unpacked when level() asks for it.
+class LevelPack {
+private:
+    MappedFile file;
+    int levelCount;
+
+public:
+    LevelPack();
+
+    LevelPack(const LevelPack &) = delete;
+    LevelPack &operator=(const LevelPack &) = delete;
+
+    /**
+   * @brief open Map a level pack.
+   * @param path
+   * @param error Receives a message when the file is not a valid pack.
+   * @return Whether the pack was opened.
+   */
+    bool open(const std::string &path, std::string &error);
+
+    /**
+   * @brief getLevelCount Get the number of levels in the pack.
+   * @return 0 while no pack is open.
+   */
+    int getLevelCount() const { return levelCount; }
+
+    /**
+   * @brief level Decode one level.
+   * @param index
+   * @param level Receives the level.
+   * @return Whether the level exists and is intact.
+   */
+    bool level(int index, std::vector<std::vector<MapTile>> &level) const;
+};
+
+/**
+ * @brief saveLevelPack Write levels into a level pack.
+ * @param path
+ * @param levels
+ * @return Whether the file was written.
+ */
+bool saveLevelPack(const std::string &path,
+                   const std::vector<std::vector<std::vector<MapTile>>> &levels);
+
+/**
+ * @brief loadLevel Load a level the way the command line tools name one: a
+ * built-in level number, <pack>:<number> or a text level file.
+ * @param argument
+ * @param level Receives the level.
+ * @param error Receives a message when there is no such level.
+ * @return Whether the level was loaded.
+ */
+bool loadLevel(const std::string &argument,
+               std::vector<std::vector<MapTile>> &level, std::string &error);
+
+#endif // LEVELPACK_H
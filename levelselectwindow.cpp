@@ -13,6 +13,35 @@
 #include "ui_levelselectwindow.h"
 #include "constants.h"
 #include "gamewindow.h"
+#include "levelpack.h"
+#include "multisimulation.h"
+#include <QCoreApplication>
+#include <QMessageBox>
+#include <map>
+
+namespace {
+
+// Levels installed next to the executable. The pack is mapped once and
+// levels are only decoded when they are opened.
+const LevelPack &installedPack() {
+    static LevelPack pack;
+    static bool opened = false;
+    if (!opened) {
+        opened = true;
+        std::string error;
+        pack.open((QCoreApplication::applicationDirPath() + "/levels.pack").toStdString(), error);
+    }
+    return pack;
+}
+
+// Pack levels decoded so far. Game windows view these tiles, so they are
+// kept for the rest of the run; a std::map never moves its elements.
+std::map<int, std::vector<std::vector<MapTile>>> &decodedLevels() {
+    static std::map<int, std::vector<std::vector<MapTile>>> decoded;
+    return decoded;
+}
+
+} // namespace
 
 LevelSelectWindow::LevelSelectWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -20,7 +49,7 @@ LevelSelectWindow::LevelSelectWindow(QWidget *parent)
 {
     ui->setupUi(this);
 
-    for(size_t i = 1; i <= (sizeof(levels) / sizeof(std::vector<std::vector<MapTile>>)); i++) {
+    for(int i = 1; i <= levelCount(); i++) {
         ui->levelListWidget->addItem(QString("Level %1").arg(i));
     }
 
@@ -33,9 +62,40 @@ LevelSelectWindow::~LevelSelectWindow()
     delete ui;
 }
 
+int LevelSelectWindow::levelCount()
+{
+    return builtInLevelCount + installedPack().getLevelCount();
+}
+
+LevelView LevelSelectWindow::levelAt(int index)
+{
+    if (index >= 0 && index < builtInLevelCount)
+        return levels[index];
+    auto found = decodedLevels().find(index);
+    if (found != decodedLevels().end())
+        return found->second;
+    std::vector<std::vector<MapTile>> level;
+    // The game plays one robot after one cheese; levels with more are left
+    // to cheese-cli and cheese-server.
+    if (!installedPack().level(index - builtInLevelCount, level) ||
+            hasManyRobots(level))
+        return LevelView();
+    std::vector<std::vector<MapTile>> &kept = decodedLevels()[index];
+    kept.swap(level);
+    return kept;
+}
+
 void LevelSelectWindow::openLevel(const QModelIndex& level) {
     int selectedLevel = level.row();
-    GameWindow* window = new GameWindow(levels[selectedLevel], selectedLevel);
+    LevelView map = levelAt(selectedLevel);
+    if (map.getWidth() == 0) {
+        QMessageBox::information(this, "Level Unavailable",
+                                 "This level cannot be played in the game. "
+                                 "Levels with several robots or cheese tiles "
+                                 "are graded with cheese-cli.");
+        return;
+    }
+    GameWindow* window = new GameWindow(map, selectedLevel);
     this->close();
     window->show();
 }
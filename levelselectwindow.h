@@ -27,6 +27,14 @@ public:
     LevelSelectWindow(QWidget *parent = nullptr);
     ~LevelSelectWindow();
 
+    // Number of levels on offer: the built-in levels, then the levels of the
+    // level pack installed next to the game
+    static int levelCount();
+
+    // Decodes a level the first time it is opened and keeps it for the rest
+    // of the run, empty if it cannot be read or needs several robots
+    static LevelView levelAt(int index);
+
 signals:
     // Called when a custom map should be loaded
     void selectMap(std::vector<std::vector<MapTile>>);
@@ -18,6 +18,8 @@
 #include <QPainterPath>
 
 #include <QPen>
+#include <algorithm>
+#include <string>
 #include <tuple>
 #include <vector>
 MachineGraph::MachineGraph(QWidget *parent) : QWidget{parent} {
@@ -33,6 +35,8 @@ MachineGraph::MachineGraph(QWidget *parent) : QWidget{parent} {
     this->setFocusPolicy(Qt::StrongFocus);
     hoverBlock = -1;
     errorBlock = -1;
+    currentRunningBlock = -1;
+    verifier.setChain(0, {chainBlock(0)});
     connecting = false;
     selecting = false;
     mousePressing = false;
@@ -124,6 +128,29 @@ void MachineGraph::drawBlock(int blockID, QPainter &painter) {
         blockColor = generalBlockColor;
     }
 
+    // Tint blocks the last run executed, the more often the redder
+    auto hot = heat.find(blockID);
+    if (hot != heat.end() && hottestExecutions > 0) {
+        const BlockCounters &counters = hot->second;
+        double share = 0.25 + 0.75 * counters.executions / hottestExecutions;
+        blockColor = QColor::fromRgbF(
+                    blockColor.redF() + (hotBlockColor.redF() - blockColor.redF()) * share,
+                    blockColor.greenF() + (hotBlockColor.greenF() - blockColor.greenF()) * share,
+                    blockColor.blueF() + (hotBlockColor.blueF() - blockColor.blueF()) * share);
+
+        std::string label = std::to_string(counters.executions) + " steps";
+        if (type == ProgramBlock::ifStatement || type == ProgramBlock::whileLoop) {
+            label = std::to_string(counters.conditionTrue) + " true, " +
+                    std::to_string(counters.conditionFalse) + " false, " +
+                    std::to_string(counters.steps) + " steps inside";
+        }
+        if (errorBlock != blockID) {
+            painter.setPen(Qt::black);
+            painter.drawText(startPoint.x() + size.x() + 10, midY + 5,
+                             label.c_str());
+        }
+    }
+
     // Draw error message
     if (errorBlock == blockID) {
         blockColor = errorBlockColor;
@@ -134,7 +161,8 @@ void MachineGraph::drawBlock(int blockID, QPainter &painter) {
                          errorMessage.c_str());
     }
 
-    if (outputMap.count(currentRunningBlock) &&
+    if (currentRunningBlock >= 0 &&
+            currentRunningBlock < (int)outputMap.size() &&
             outputMap[currentRunningBlock] == blockID) {
         blockColor = runningBlockColor;
     }
@@ -375,7 +403,30 @@ void MachineGraph::drawTextFromMid(QPointF position, std::string text,
 void MachineGraph::connectBlock(int block1, int block2) {
     if (!reachable(block2, block1)) {
         blockTree[block1] = block2;
+        refreshChain(block1);
+    }
+}
+
+ChainBlock MachineGraph::chainBlock(int blockID) {
+    ChainBlock block{blockID, std::get<ProgramBlock>(map[blockID]),
+                     ProgramBlock::blank, ProgramBlock::blank};
+    if (condition.count(blockID)) {
+        block.isNot = std::get<0>(condition[blockID]);
+        block.facing = std::get<1>(condition[blockID]);
+    }
+    return block;
+}
+
+void MachineGraph::refreshChain(int blockID) {
+    int position = verifier.positionOf(blockID);
+    if (position < 0)
+        return;
+    // Everything before the block is unchanged and is not checked again.
+    std::vector<ChainBlock> blocks;
+    for (int current = blockID; current != -1; current = blockTree[current]) {
+        blocks.push_back(chainBlock(current));
     }
+    verifier.setChain(position, blocks);
 }
 
 void MachineGraph::toggleConnecting() {
@@ -607,6 +658,7 @@ void MachineGraph::addBlock(ProgramBlock type, QPointF position) {
             } else {
                 std::get<1>(condition[blockId]) = type;
             }
+            refreshChain(blockId);
         }
         return;
     }
@@ -669,6 +721,7 @@ void MachineGraph::removeBlocks() {
             for (unsigned long i = 0; i < blockTree.size(); i++) {
                 if (blockTree[i] == id) {
                     blockTree[i] = -1;
+                    refreshChain(i);
                 }
             }
             map.erase(id);
@@ -687,59 +740,17 @@ void MachineGraph::setErrorMessage(int blockId, std::string message) {
 }
 
 std::vector<ProgramBlock> MachineGraph::getProgram() {
-    int currentBlock = 0;
-    std::vector<int> blockId;
-    std::vector<ProgramBlock> program;
-    std::vector<ProgramBlock> grammaStack;
-    outputMap.clear();
-    while (currentBlock != -1) {
-        int next = blockTree[currentBlock];
-        ProgramBlock type = std::get<ProgramBlock>(map[currentBlock]);
-        outputMap[program.size()] = currentBlock;
-        program.push_back(type);
-        if (type == ProgramBlock::ifStatement || type == ProgramBlock::whileLoop) {
-            grammaStack.push_back(type);
-            blockId.push_back(currentBlock);
-            ProgramBlock firstConst = std::get<0>(condition[currentBlock]);
-            ProgramBlock secondConst = std::get<1>(condition[currentBlock]);
-            if (secondConst == ProgramBlock::blank) {
-                setErrorMessage(currentBlock, "Incomplete conditinal statement");
-                return std::vector<ProgramBlock>(ProgramBlock::blank);
-            } else {
-                program.push_back(firstConst);
-                program.push_back(secondConst);
-            }
-        }
-
-        if (type == ProgramBlock::endIf) {
-            if (grammaStack.empty() ||
-                    grammaStack.back() != ProgramBlock::ifStatement) {
-                setErrorMessage(currentBlock, "No matched If statement for End If");
-                return std::vector<ProgramBlock>(ProgramBlock::blank);
-            } else {
-                grammaStack.pop_back();
-                blockId.pop_back();
-            }
-        }
-
-        if (type == ProgramBlock::endWhile) {
-            if (grammaStack.empty() ||
-                    grammaStack.back() != ProgramBlock::whileLoop) {
-                setErrorMessage(currentBlock, "No matched If statement for End While");
-                return std::vector<ProgramBlock>(ProgramBlock::blank);
-            } else {
-                grammaStack.pop_back();
-                blockId.pop_back();
-            }
-        }
-        currentBlock = next;
-    }
-
-    if (!grammaStack.empty()) {
-        setErrorMessage(blockId.back(), "Needs end statement");
-        return std::vector<ProgramBlock>(ProgramBlock::blank);
+    // The verifier already checked the chain while it was edited.
+    if (!verifier.isValid()) {
+        setErrorMessage(verifier.getErrorBlock(), verifier.getErrorMessage());
+        return std::vector<ProgramBlock>();
     }
 
+    const std::vector<ProgramBlock> &program = verifier.getProgram();
+    outputMap = verifier.getBlockIds();
+    // The heatmap belongs to the previous run
+    heat.clear();
+    hottestExecutions = 0;
     emit programData(program);
 
     return program;
@@ -749,3 +760,17 @@ void MachineGraph::setRunningBlock(int blockID) {
     this->currentRunningBlock = blockID;
     update();
 }
+
+void MachineGraph::setProfile(const BlockProfile &profile) {
+    heat.clear();
+    hottestExecutions = 0;
+    const std::vector<BlockCounters> &counters = profile.getCounters();
+    for (unsigned long long index = 0;
+         index < counters.size() && index < outputMap.size(); index++) {
+        if (counters[index].executions == 0)
+            continue;
+        heat[outputMap[index]] = counters[index];
+        hottestExecutions = std::max(hottestExecutions, counters[index].executions);
+    }
+    update();
+}
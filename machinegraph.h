@@ -12,7 +12,9 @@
 #ifndef MACHINEGRAPH_H
 #define MACHINEGRAPH_H
 
+#include "blockprofile.h"
 #include "constants.h"
+#include "programverifier.h"
 #include <QWidget>
 
 class MachineGraph : public QWidget {
@@ -40,10 +42,19 @@ private:
 
     const QColor runningBlockColor = QColor::fromRgb(255, 255, 255);
 
+    const QColor hotBlockColor = QColor::fromRgb(255, 87, 34);
+
     // Map from blockID to the block's info.
     std::map<int, std::tuple<ProgramBlock, QPointF, QPoint>> map;
     std::map<int, std::tuple<ProgramBlock, ProgramBlock>> condition;
-    std::map<int, int> outputMap;
+    // Block id of every program index of the program last sent for running.
+    std::vector<int> outputMap;
+    // Counters of the last finished run per block id, empty before a run.
+    std::map<int, BlockCounters> heat;
+    long long hottestExecutions = 0;
+
+    // Checks the chain from the begin block as it is edited.
+    ProgramVerifier verifier;
 
     // Manage connection between blocks.
     std::vector<int> blockTree;
@@ -81,6 +92,20 @@ private:
    */
     void connectBlock(int block1, int block2);
 
+    /**
+   * @brief chainBlock Get a block with its conditions for the verifier.
+   * @param blockID
+   * @return
+   */
+    ChainBlock chainBlock(int blockID);
+
+    /**
+   * @brief refreshChain Check the program again from a block whose link or
+   * conditions changed. Blocks outside the program are ignored.
+   * @param blockID
+   */
+    void refreshChain(int blockID);
+
     /**
    * @brief drawBlock Helper method for paintEvent, draw a single block.
    * @param blockID
@@ -222,6 +247,13 @@ public slots:
    */
     void setRunningBlock(int blockID);
 
+    /**
+   * @brief setProfile Tint blocks by how often the finished run executed
+   * them and label them with their counts.
+   * @param profile
+   */
+    void setProfile(const BlockProfile &profile);
+
 signals:
 
     /**
@@ -0,0 +1,69 @@
+/**
+ * @file mappedfile.cpp
+ * @brief Read-only memory maps of whole files.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "mappedfile.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), size(0) {}
+
+MappedFile::~MappedFile() { close(); }
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (data && fallback.empty()) {
+        munmap((void *)data, size);
+    }
+#endif
+    fallback.clear();
+    data = nullptr;
+    size = 0;
+}
+
+bool MappedFile::open(const std::string &path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        return false;
+    }
+    size = info.st_size;
+    if (size > 0) {
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+            data = (const unsigned char *)mapping;
+    }
+    ::close(fd);
+#endif
+    if (!data) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            size = 0;
+            return false;
+        }
+        fallback.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+        // Keep the buffer non-empty so data marks the file as open.
+        fallback.push_back(0);
+        data = fallback.data();
+        size = fallback.size() - 1;
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file mappedfile.h
+ * @brief Header file for mappedfile.cpp, read-only memory maps of whole files.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// A whole file mapped read-only into memory. Pages are only read from disk
+/// when they are touched, so opening even a large file is instant. Where
+/// memory maps are not available the file is read into a buffer instead.
+class MappedFile {
+private:
+    const unsigned char *data;
+    std::uint64_t size;
+    // Copy of the file where memory maps are not available.
+    std::vector<unsigned char> fallback;
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+   * @brief open Map a file, releasing any file mapped before.
+   * @param path
+   * @return Whether the file could be read.
+   */
+    bool open(const std::string &path);
+
+    /**
+   * @brief close Release the mapping.
+   */
+    void close();
+
+    /**
+   * @brief getData Get the first byte of the file.
+   * @return nullptr while no file is open.
+   */
+    const unsigned char *getData() const { return data; }
+
+    std::uint64_t getSize() const { return size; }
+};
+
+#endif // MAPPEDFILE_H
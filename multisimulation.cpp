@@ -0,0 +1,239 @@
+/**
+ * @file multisimulation.cpp
+ * @brief Levels with several robots and several cheese tiles.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "multisimulation.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+MultiSimulation::MultiSimulation(
+        const std::vector<std::vector<MapTile>> &newMap,
+        const std::vector<std::vector<ProgramBlock>> &newPrograms)
+    : state(notEnded), grid(newMap), cheeseLeft(0), tickCount(0),
+      blockHash(0), knownUntil(0), repeatTick(-1) {
+    for (const std::vector<ProgramBlock> &program : newPrograms) {
+        programs.push_back(compileProgram(program));
+    }
+    occupancy.assign(grid.getStride() * (grid.getHeight() + 2), -1);
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            int cell = grid.index(x, y);
+            if (newMap[y][x] == start) {
+                int number = robots.size();
+                int program = programs.empty() ? -1 : number % programs.size();
+                robots.push_back(Robot{program, 0, cell, east, notEnded});
+                occupancy[cell] = number;
+            }
+            if (grid.at(cell) & tileCheese)
+                cheeseLeft++;
+            if (grid.at(cell) & tileBlock)
+                blockHash ^= blockKey(cell);
+        }
+    }
+    // Without robots or programs nothing can ever eat the cheese.
+    if (robots.empty() || programs.empty())
+        state = lost;
+}
+
+void MultiSimulation::step() {
+    changes.clear();
+    if (state != notEnded)
+        return;
+    if (!origin)
+        origin = std::make_shared<const MultiSimulation>(*this);
+    advance();
+    if (state != notEnded)
+        return;
+    // The run is deterministic, so reaching a state twice means it loops.
+    // Up to knownUntil a look ahead already found out, past it look twice as
+    // far.
+    if (tickCount > knownUntil)
+        lookFurther(lookAheadTick(tickCount));
+    if (tickCount == repeatTick)
+        state = nonTerminating;
+}
+
+RunResult MultiSimulation::runUntilDone(int maxSteps) {
+    if (state == notEnded && tickCount < maxSteps) {
+        if (!origin)
+            origin = std::make_shared<const MultiSimulation>(*this);
+        if (knownUntil < maxSteps)
+            lookFurther(maxSteps);
+        // Nothing repeats before repeatTick, so no state needs checking.
+        int end = repeatTick >= 0 ? std::min(repeatTick, maxSteps) : maxSteps;
+        while (state == notEnded && tickCount < end) {
+            advance();
+        }
+        if (state == notEnded && tickCount == repeatTick)
+            state = nonTerminating;
+    }
+    return RunResult{state, tickCount};
+}
+
+void MultiSimulation::advance() {
+    changes.clear();
+    tickCount++;
+    bool running = false;
+    bool ate = false;
+    for (Robot &robot : robots) {
+        if (robot.state != notEnded)
+            continue;
+        execute(robot);
+        if (robot.state == lost)
+            state = lost;
+        ate = ate || robot.state == won;
+        running = running || robot.state == notEnded;
+    }
+
+    if (state != notEnded)
+        return;
+    // Only eating the last cheese wins, as in SimulationCore a level without
+    // cheese is never won.
+    if (ate && cheeseLeft == 0) {
+        state = won;
+    } else if (!running) {
+        state = lost;
+    }
+}
+
+void MultiSimulation::lookFurther(int tick) {
+    RepeatSearch found = findRepeat(*origin, tick);
+    knownUntil = found.knownUntil;
+    repeatTick = found.repeatTick;
+}
+
+void MultiSimulation::execute(Robot &robot) {
+    const std::vector<Instruction> &code = programs[robot.program];
+    if (robot.pc == (int)code.size()) {
+        removeRobot(robot, lost);
+        return;
+    }
+    const Instruction &instruction = code[robot.pc];
+    robot.pc++;
+
+    switch (instruction.op) {
+    case opMove:
+        moveRobot(robot);
+        break;
+    case opTurnLeft:
+        robot.robotDirection = rotate(robot.robotDirection, 3);
+        break;
+    case opTurnRight:
+        robot.robotDirection = rotate(robot.robotDirection, 1);
+        break;
+    case opEat:
+        if (grid.at(robot.cell) & tileCheese) {
+            setCell(robot.cell, grid.at(robot.cell) & ~tileCheese);
+            cheeseLeft--;
+            removeRobot(robot, won);
+        }
+        break;
+    case opBranch:
+        if (!conditionHolds(facingBits(robot), instruction.mask,
+                            instruction.negate))
+            robot.pc = instruction.target;
+        break;
+    case opJump:
+        robot.pc = instruction.target;
+        break;
+    default:
+        break;
+    }
+}
+
+void MultiSimulation::moveRobot(Robot &robot) {
+    int offset = grid.offset(robot.robotDirection);
+    int newCell = robot.cell + offset;
+    int newBoxCell = newCell + offset;
+    // Robots are solid, moveOutcome stops at anything marked as a wall.
+    unsigned char facing = facingBits(robot);
+    unsigned char behind = 0;
+    if (facing & tileBlock) {
+        behind = grid.at(newBoxCell);
+        if (occupancy[newBoxCell] >= 0)
+            behind |= tileWall;
+    }
+
+    switch (moveOutcome(facing, behind)) {
+    case moveFalls:
+        removeRobot(robot, lost);
+        return;
+    case movePushes:
+        setCell(newBoxCell, behind | tileBlock);
+        setCell(newCell, facing & ~tileBlock);
+        break;
+    case moveDropsBlock:
+        setCell(newCell, facing & ~tileBlock);
+        break;
+    case moveWalks:
+        break;
+    case moveBlocked:
+        return;
+    }
+    occupancy[newCell] = occupancy[robot.cell];
+    occupancy[robot.cell] = -1;
+    robot.cell = newCell;
+}
+
+void MultiSimulation::removeRobot(Robot &robot, gameState outcome) {
+    occupancy[robot.cell] = -1;
+    robot.cell = -1;
+    robot.state = outcome;
+}
+
+unsigned char MultiSimulation::facingBits(const Robot &robot) const {
+    int ahead = robot.cell + grid.offset(robot.robotDirection);
+    unsigned char bits = grid.at(ahead);
+    return occupancy[ahead] >= 0 ? bits | tileWall : bits;
+}
+
+void MultiSimulation::setCell(int cell, unsigned char bits) {
+    if ((grid.at(cell) ^ bits) & tileBlock)
+        blockHash ^= blockKey(cell);
+    grid.set(cell, bits);
+    int x = grid.getX(cell);
+    int y = grid.getY(cell);
+    changes.push_back(TileChange{x, y, grid.tileAt(x, y)});
+}
+
+std::uint64_t MultiSimulation::getStateHash() const {
+    // Eaten cheese never comes back, so the count tells the boards apart.
+    std::uint64_t hash = blockHash ^ mixHash(cheeseLeft);
+    for (unsigned long long number = 0; number < robots.size(); number++) {
+        const Robot &robot = robots[number];
+        hash ^= mixHash(robotKey(robot.pc, robot.cell, robot.robotDirection) +
+                        number);
+    }
+    return hash;
+}
+
+Point MultiSimulation::getRobotPos(int robot) const {
+    int cell = robots[robot].cell;
+    if (cell < 0)
+        return Point{-1, -1};
+    return Point{grid.getX(cell), grid.getY(cell)};
+}
+
+std::vector<std::vector<MapTile>> MultiSimulation::getMap() const {
+    return grid.toMap();
+}
+
+bool hasManyRobots(const std::vector<std::vector<MapTile>> &level) {
+    int starts = 0;
+    int cheeses = 0;
+    for (const std::vector<MapTile> &row : level) {
+        for (MapTile tile : row) {
+            starts += tile == start;
+            cheeses += tile == cheese;
+        }
+    }
+    return starts > 1 || cheeses > 1;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file multisimulation.h
+ * @brief Header file for multisimulation.cpp, levels with several robots and
+ * several cheese tiles.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef MULTISIMULATION_H
+#define MULTISIMULATION_H
+
+#include "bytecode.h"
+#include "constants.h"
+#include "cyclesearch.h"
+#include "simulationcore.h"
+#include "tilegrid.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// One robot of a MultiSimulation.
+struct Robot {
+    // Index of the program the robot runs.
+    int program;
+    // Index into the compiled program of the next instruction.
+    int pc;
+    // Cell index of the robot, -1 once it left the board.
+    int cell;
+    direction robotDirection;
+    // notEnded while running, won once it ate a cheese, lost once it fell or
+    // ran out of program.
+    gameState state;
+};
+
+/// Runs many robots on one board. Every start tile holds a robot facing
+/// east, numbered in reading order. Each tick every robot still running
+/// executes one block, lowest number first, so a robot sees the moves the
+/// robots before it made in the same tick.
+///
+/// Robots are solid to each other: a robot cannot walk into another one or
+/// push a block into one, and senses one in front of it as a wall. A robot
+/// that eats a cheese leaves the board. The level is won once the last
+/// cheese is eaten, so a level without cheese is never won. It is lost once
+/// any robot is lost, or when every robot has left with cheese still on the
+/// board. The game ends after the tick that decided it.
+class MultiSimulation {
+private:
+    gameState state;
+    TileGrid grid;
+    std::vector<std::vector<Instruction>> programs;
+    std::vector<Robot> robots;
+    // Number of the robot on each cell index, -1 if none.
+    std::vector<int> occupancy;
+    int cheeseLeft;
+    int tickCount;
+    // Tiles changed by the last step.
+    std::vector<TileChange> changes;
+    // XOR of blockKey over every cell holding a block.
+    std::uint64_t blockHash;
+    // Last tick looked ahead to. No state repeats before it except at
+    // repeatTick, which is -1 if none does.
+    int knownUntil;
+    int repeatTick;
+    // The board before the first step, where looking ahead starts from, so
+    // no reached state has to be remembered. nullptr until then.
+    std::shared_ptr<const MultiSimulation> origin;
+
+public:
+    /**
+   * @brief MultiSimulation Place a robot on every start tile.
+   * @param newMap
+   * @param newPrograms One program shared by every robot, or one per robot.
+   * With fewer programs than robots they are handed out in turn.
+   */
+    MultiSimulation(const std::vector<std::vector<MapTile>> &newMap,
+                    const std::vector<std::vector<ProgramBlock>> &newPrograms);
+
+    /**
+   * @brief step Let every running robot execute its next block.
+   */
+    void step();
+
+    /**
+   * @brief runUntilDone Step until the game ends or maxSteps steps have been
+   * executed in total. Looks ahead for a repeated state once, so the steps
+   * themselves check nothing.
+   * @param maxSteps
+   * @return The final state, notEnded if the step limit was hit.
+   */
+    RunResult runUntilDone(int maxSteps);
+
+    /**
+   * @brief getRobots Get every robot, in update order.
+   * @return
+   */
+    const std::vector<Robot> &getRobots() const { return robots; }
+
+    /**
+   * @brief getRobotPos Get a robot's position.
+   * @param robot
+   * @return {-1, -1} once the robot left the board.
+   */
+    Point getRobotPos(int robot) const;
+
+    /**
+   * @brief getRobotAt Find the robot standing on a map cell.
+   * @param x
+   * @param y
+   * @return -1 if the cell is free.
+   */
+    int getRobotAt(int x, int y) const { return occupancy[grid.index(x, y)]; }
+
+    /**
+   * @brief getCheeseLeft Get the number of cheese tiles not eaten yet.
+   * @return
+   */
+    int getCheeseLeft() const { return cheeseLeft; }
+
+    /**
+   * @brief getGameState Get the current game state.
+   * @return
+   */
+    gameState getGameState() const { return state; }
+
+    /**
+   * @brief getTickCount Get the number of steps executed so far.
+   * @return
+   */
+    int getTickCount() const { return tickCount; }
+
+    /**
+   * @brief getMap Get the current map, without the robots.
+   * @return
+   */
+    std::vector<std::vector<MapTile>> getMap() const;
+
+    /**
+   * @brief getChanges Get the tiles changed by the last step.
+   * @return
+   */
+    const std::vector<TileChange> &getChanges() const { return changes; }
+
+private:
+    /**
+   * @brief advance Let every running robot execute its next block, and
+   * decide the game except for repeated states.
+   */
+    void advance();
+
+    /**
+   * @brief lookFurther Find out from origin whether and where the run first
+   * repeats a state, looking at least up to a tick, and update knownUntil
+   * and repeatTick.
+   * @param tick
+   */
+    void lookFurther(int tick);
+
+    template <class Simulation>
+    friend RepeatSearch findRepeat(const Simulation &start, int tick);
+
+    /**
+   * @brief execute Run one instruction of a robot.
+   * @param robot
+   */
+    void execute(Robot &robot);
+
+    /**
+   * @brief moveRobot Move a robot one cell forward, pushing any block.
+   * @param robot
+   */
+    void moveRobot(Robot &robot);
+
+    /**
+   * @brief removeRobot Take a robot off the board.
+   * @param robot
+   * @param outcome won or lost.
+   */
+    void removeRobot(Robot &robot, gameState outcome);
+
+    /**
+   * @brief facingBits Get the class bits the robot senses in front of it,
+   * with another robot sensed as a wall.
+   * @param robot
+   * @return
+   */
+    unsigned char facingBits(const Robot &robot) const;
+
+    void setCell(int cell, unsigned char bits);
+
+    /**
+   * @brief getStateHash Get a hash of the board and every robot.
+   * @return
+   */
+    std::uint64_t getStateHash() const;
+};
+
+/**
+ * @brief hasManyRobots Whether a level has several robots or cheese tiles and
+ * needs MultiSimulation.
+ * @param level
+ * @return
+ */
+bool hasManyRobots(const std::vector<std::vector<MapTile>> &level);
+
+#endif // MULTISIMULATION_H
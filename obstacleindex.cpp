@@ -0,0 +1,82 @@
+/**
+ * @file obstacleindex.cpp
+ * @brief Distances to the next obstacle along every row and column of a map.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "obstacleindex.h"
+#include <vector>
+
+int ObstacleIndex::freeAhead(const TileGrid &grid, int cell, direction dir) {
+    int stride = grid.getStride();
+    if (rows.empty()) {
+        rows.resize(grid.getHeight() + 2);
+        columns.resize(stride);
+    }
+    int row = cell / stride;
+    int column = cell % stride;
+    switch (dir) {
+    case east:
+    case west:
+        if (rows[row].empty())
+            buildRow(grid, row);
+        return rows[row][(dir == east ? 0 : stride) + column];
+    case south:
+    case north:
+        if (columns[column].empty())
+            buildColumn(grid, column);
+        return columns[column][(dir == south ? 0 : grid.getHeight() + 2) + row];
+    }
+    return 0;
+}
+
+void ObstacleIndex::invalidate(const TileGrid &grid, int cell) {
+    if (rows.empty())
+        return;
+    // clear keeps the capacity for the rebuild.
+    rows[cell / grid.getStride()].clear();
+    columns[cell % grid.getStride()].clear();
+}
+
+void ObstacleIndex::clear() {
+    rows.clear();
+    columns.clear();
+}
+
+void ObstacleIndex::buildRow(const TileGrid &grid, int row) {
+    int length = grid.getStride();
+    int first = row * length;
+    std::vector<int> &free = rows[row];
+    free.resize(2 * length);
+    // The padding ends every row, so the outermost cells face nothing free.
+    free[length - 1] = 0;
+    for (int x = length - 2; x >= 0; x--) {
+        free[x] = (grid.at(first + x + 1) & tileSolid) ? 0 : free[x + 1] + 1;
+    }
+    free[length] = 0;
+    for (int x = 1; x < length; x++) {
+        free[length + x] =
+                (grid.at(first + x - 1) & tileSolid) ? 0 : free[length + x - 1] + 1;
+    }
+}
+
+void ObstacleIndex::buildColumn(const TileGrid &grid, int column) {
+    int stride = grid.getStride();
+    int length = grid.getHeight() + 2;
+    std::vector<int> &free = columns[column];
+    free.resize(2 * length);
+    free[length - 1] = 0;
+    for (int y = length - 2; y >= 0; y--) {
+        free[y] = (grid.at((y + 1) * stride + column) & tileSolid) ? 0
+                                                                    : free[y + 1] + 1;
+    }
+    free[length] = 0;
+    for (int y = 1; y < length; y++) {
+        free[length + y] = (grid.at((y - 1) * stride + column) & tileSolid)
+                                   ? 0
+                                   : free[length + y - 1] + 1;
+    }
+}
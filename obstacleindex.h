@@ -0,0 +1,71 @@
+/**
+ * @file obstacleindex.h
+ * @brief Header file for obstacleindex.cpp, distances to the next obstacle
+ * along every row and column of a map.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OBSTACLEINDEX_H
+#define OBSTACLEINDEX_H
+
+#include "constants.h"
+#include "tilegrid.h"
+#include <vector>
+
+/// For every cell and direction, how many cells the robot can walk before it
+/// faces something solid. Rows hold the east and west distances and columns
+/// the north and south ones. A row or column is only built when it is first
+/// queried and dropped when one of its cells changes, so huge maps cost
+/// nothing for the lines the robot never walks along.
+class ObstacleIndex {
+private:
+    // Per padded row, the east distances of its cells followed by the west
+    // ones. Empty while out of date.
+    std::vector<std::vector<int>> rows;
+    // Per padded column, the south distances followed by the north ones.
+    std::vector<std::vector<int>> columns;
+
+public:
+    /**
+   * @brief freeAhead Count the cells the robot can walk into in a row.
+   * @param grid The grid the index describes.
+   * @param cell
+   * @param dir
+   * @return
+   */
+    int freeAhead(const TileGrid &grid, int cell, direction dir);
+
+    /**
+   * @brief invalidate Mark the row and column of a cell whose solid bits
+   * changed.
+   * @param grid
+   * @param cell
+   */
+    void invalidate(const TileGrid &grid, int cell);
+
+    /**
+   * @brief clear Forget every distance, after the whole grid was replaced.
+   */
+    void clear();
+
+private:
+    /**
+   * @brief buildRow Recompute the east and west distances of a padded row.
+   * @param grid
+   * @param row
+   */
+    void buildRow(const TileGrid &grid, int row);
+
+    /**
+   * @brief buildColumn Recompute the north and south distances of a padded
+   * column.
+   * @param grid
+   * @param column
+   */
+    void buildColumn(const TileGrid &grid, int column);
+};
+
+#endif // OBSTACLEINDEX_H
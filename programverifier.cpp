@@ -0,0 +1,139 @@
+/**
+ * @file programverifier.cpp
+ * @brief Bracket matching and error checking of a chain of program blocks.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "programverifier.h"
+#include <string>
+#include <vector>
+
+ProgramVerifier::ProgramVerifier() : errorPosition(-1), unclosed(-1) {}
+
+ProgramVerifier::ProgramVerifier(const std::vector<ProgramBlock> &program)
+    : ProgramVerifier() {
+    std::vector<ChainBlock> blocks;
+    for (unsigned long long index = 0; index < program.size(); index++) {
+        ChainBlock block{(int)index, program[index], blank, blank};
+        if (index == 0) {
+            // Block 0 is the begin block whatever it holds.
+            block.type = beginBlock;
+        } else if (block.type == ifStatement || block.type == whileLoop) {
+            if (index + 2 < program.size()) {
+                block.isNot = program[index + 1];
+                block.facing = program[index + 2];
+            }
+            // Skip the two condition slots.
+            index += 2;
+        }
+        blocks.push_back(block);
+    }
+    setChain(0, blocks);
+}
+
+void ProgramVerifier::setChain(int from, const std::vector<ChainBlock> &blocks) {
+    for (unsigned long long position = from; position < chain.size(); position++) {
+        positions.erase(chain[position].id);
+    }
+    chain.resize(from);
+    chain.insert(chain.end(), blocks.begin(), blocks.end());
+    for (unsigned long long position = from; position < chain.size(); position++) {
+        positions[chain[position].id] = position;
+    }
+    verifyFrom(from);
+}
+
+int ProgramVerifier::positionOf(int id) const {
+    auto found = positions.find(id);
+    return found == positions.end() ? -1 : found->second;
+}
+
+int ProgramVerifier::getErrorBlock() const {
+    if (errorPosition >= 0)
+        return chain[errorPosition].id;
+    return unclosed >= 0 ? chain[unclosed].id : -1;
+}
+
+const std::string &ProgramVerifier::getErrorMessage() const {
+    static const std::string unclosedMessage = "Needs end statement";
+    static const std::string noMessage;
+    if (errorPosition >= 0)
+        return errorMessage;
+    return unclosed >= 0 ? unclosedMessage : noMessage;
+}
+
+void ProgramVerifier::verifyFrom(int from) {
+    // Drop what the replaced blocks produced.
+    int start = from < (int)programStart.size() ? programStart[from] : program.size();
+    program.resize(start);
+    blockIds.resize(start);
+    jumps.resize(start);
+    programStart.resize(from);
+    openAfter.resize(from);
+    enclosing.resize(from);
+    if (errorPosition >= from) {
+        errorPosition = -1;
+        errorMessage.clear();
+    }
+
+    // Heads open before the change may have been closed after it.
+    int open = from > 0 ? openAfter[from - 1] : -1;
+    for (int head = open; head != -1; head = enclosing[head]) {
+        jumps[programStart[head]] = -1;
+    }
+
+    for (int position = from; position < (int)chain.size(); position++) {
+        const ChainBlock &block = chain[position];
+        int index = program.size();
+        programStart.push_back(index);
+        enclosing.push_back(-1);
+        program.push_back(block.type);
+        blockIds.push_back(block.id);
+        jumps.push_back(-1);
+
+        switch (block.type) {
+        case ifStatement:
+        case whileLoop:
+            program.push_back(block.isNot);
+            program.push_back(block.facing);
+            blockIds.insert(blockIds.end(), 2, block.id);
+            jumps.insert(jumps.end(), 2, -1);
+            if (block.facing == blank)
+                fail(position, "Incomplete conditinal statement");
+            enclosing[position] = open;
+            open = position;
+            break;
+        case endIf:
+        case endWhile:
+            if (block.type == endIf &&
+                    (open < 0 || chain[open].type != ifStatement)) {
+                fail(position, "No matched If statement for End If");
+            }
+            if (block.type == endWhile &&
+                    (open < 0 || chain[open].type != whileLoop)) {
+                fail(position, "No matched While statement for End While");
+            }
+            // Close the innermost head even when it is the wrong kind.
+            if (open >= 0) {
+                jumps[programStart[open]] = index;
+                jumps[index] = programStart[open];
+                open = enclosing[open];
+            }
+            break;
+        default:
+            break;
+        }
+        openAfter.push_back(open);
+    }
+    unclosed = open;
+}
+
+void ProgramVerifier::fail(int position, const std::string &message) {
+    if (errorPosition < 0) {
+        errorPosition = position;
+        errorMessage = message;
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file programverifier.h
+ * @brief Header file for programverifier.cpp, bracket matching and error
+ * checking of a chain of program blocks.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef PROGRAMVERIFIER_H
+#define PROGRAMVERIFIER_H
+
+#include "constants.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// One block of the chain the editor links together from the begin block.
+struct ChainBlock {
+    // Editor block id, reported back in diagnostics and the block map.
+    int id;
+    ProgramBlock type;
+    // Condition slots of an if / while head, conditionNot or blank and the
+    // facing condition. Ignored for other blocks.
+    ProgramBlock isNot;
+    ProgramBlock facing;
+};
+
+/// The only place if / end if and while / end while are matched. A single
+/// pass over the chain builds the flat program, the jump table, the program
+/// index to block id map and the first error together. The matching state
+/// after every block is kept, so when the chain changes from some block on
+/// only that part is checked again.
+///
+/// Matching is lenient so the interpreter can run any program: an end closes
+/// the innermost open head whatever its type, a stray end matches nothing and
+/// a head left open matches nothing. The first of these is still reported.
+class ProgramVerifier {
+private:
+    std::vector<ChainBlock> chain;
+    // Per chain position, the program index of the block.
+    std::vector<int> programStart;
+    // Per chain position, the chain position of the innermost head still
+    // open after it, -1 if none.
+    std::vector<int> openAfter;
+    // Per chain position of a head, the head open around it, -1 if none.
+    // With openAfter this keeps every state of the open stack.
+    std::vector<int> enclosing;
+    // Chain position of every editor block id in the chain.
+    std::unordered_map<int, int> positions;
+
+    std::vector<ProgramBlock> program;
+    std::vector<int> blockIds;
+    std::vector<int> jumps;
+
+    // Chain position of the first misplaced or incomplete block, -1 if none.
+    int errorPosition;
+    std::string errorMessage;
+    // Chain position of the innermost head left open at the end, -1 if none.
+    int unclosed;
+
+public:
+    ProgramVerifier();
+
+    /**
+   * @brief ProgramVerifier Verify a flat program, as produced by
+   * MachineGraph or parseProgram. Block ids are then program indices, and the
+   * program and jump table index like the given program.
+   * @param program
+   */
+    explicit ProgramVerifier(const std::vector<ProgramBlock> &program);
+
+    /**
+   * @brief setChain Replace the chain from a position on and check it again
+   * from there. Everything before the position is kept as it was.
+   * @param from Chain position of the first changed block, at most the
+   * current length.
+   * @param blocks The new blocks from that position to the end of the chain.
+   */
+    void setChain(int from, const std::vector<ChainBlock> &blocks);
+
+    /**
+   * @brief positionOf Find the chain position of an editor block.
+   * @param id
+   * @return -1 if the block is not part of the chain.
+   */
+    int positionOf(int id) const;
+
+    /**
+   * @brief isValid See whether the chain has no errors.
+   * @return
+   */
+    bool isValid() const { return errorPosition < 0 && unclosed < 0; }
+
+    /**
+   * @brief getErrorBlock Get the block the first error is reported on.
+   * @return The editor block id, -1 if there is no error.
+   */
+    int getErrorBlock() const;
+
+    /**
+   * @brief getErrorMessage
+   * @return Empty if there is no error.
+   */
+    const std::string &getErrorMessage() const;
+
+    /**
+   * @brief getProgram Get the flat program, every head followed by its two
+   * condition slots.
+   * @return
+   */
+    const std::vector<ProgramBlock> &getProgram() const { return program; }
+
+    /**
+   * @brief getBlockIds Get the editor block id of every program index.
+   * Condition slots map to their head.
+   * @return
+   */
+    const std::vector<int> &getBlockIds() const { return blockIds; }
+
+    /**
+   * @brief getJumps Get the jump table. Every matched head and end holds the
+   * program index of the other, any other index holds -1.
+   * @return
+   */
+    const std::vector<int> &getJumps() const { return jumps; }
+
+private:
+    /**
+   * @brief verifyFrom Rebuild the program and matching state from a chain
+   * position to the end of the chain.
+   * @param from
+   */
+    void verifyFrom(int from);
+
+    /**
+   * @brief fail Record an error unless an earlier one was found.
+   * @param position
+   * @param message
+   */
+    void fail(int position, const std::string &message);
+};
+
+#endif // PROGRAMVERIFIER_H
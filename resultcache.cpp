@@ -0,0 +1,230 @@
+/**
+ * @file resultcache.cpp
+ * @brief Remembers how programs end on levels so graders do not run the same
+ * submission twice.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "resultcache.h"
+#include "byteorder.h"
+#include "bytecode.h"
+#include "mappedfile.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// File layout, all integers little endian:
+//   header    "ECRC", format version u32, SEMANTICS_VERSION u32
+//   results   key high u64, key low u64, steps u32, gameState u32
+// Later results for a key replace earlier ones.
+namespace {
+
+const char cacheMagic[] = "ECRC";
+const std::uint32_t cacheVersion = 1;
+const int headerSize = 12;
+const int recordSize = 24;
+
+std::vector<unsigned char> header() {
+    std::vector<unsigned char> bytes(cacheMagic, cacheMagic + 4);
+    put32(bytes, cacheVersion);
+    put32(bytes, SEMANTICS_VERSION);
+    return bytes;
+}
+
+void putRecord(std::vector<unsigned char> &buffer, const ResultKey &key,
+               gameState state, int steps) {
+    put64(buffer, key.high);
+    put64(buffer, key.low);
+    put32(buffer, steps);
+    put32(buffer, state);
+}
+
+/// Two independently seeded hash chains, so a key is 128 bits.
+void hashWord(ResultKey &key, std::uint64_t word) {
+    key.high = mixHash(key.high ^ word);
+    key.low = mixHash(key.low + mixHash(word));
+}
+
+} // namespace
+
+ResultKey resultKey(LevelView level, const std::vector<ProgramBlock> &program) {
+    ResultKey key{0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL};
+    hashWord(key, level.getWidth());
+    hashWord(key, level.getHeight());
+    for (int y = 0; y < level.getHeight(); y++) {
+        for (int x = 0; x < level.getWidth(); x++) {
+            hashWord(key, level.at(x, y));
+        }
+    }
+
+    // Source block indices only name blocks for the editor, leave them out.
+    std::vector<Instruction> code = compileProgram(program);
+    hashWord(key, code.size());
+    for (const Instruction &instruction : code) {
+        hashWord(key, (std::uint64_t)instruction.op |
+                 (std::uint64_t)instruction.negate << 8 |
+                 (std::uint64_t)(std::uint32_t)instruction.condition << 16);
+        hashWord(key, (std::uint32_t)instruction.target);
+    }
+    return key;
+}
+
+ResultCache::ResultCache(int newCapacity)
+    : capacity(newCapacity > 0 ? newCapacity : 1) {}
+
+bool ResultCache::open(const std::string &path, std::string &error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    file.close();
+
+    // Keep what a compatible file holds, in the order it was written. The
+    // last word on every key is also gathered, so a compacted file drops only
+    // results that were superseded, never ones that did not fit in memory.
+    bool rewrite = true;
+    std::uint64_t records = 0;
+    std::vector<Entry> latest;
+    std::unordered_map<ResultKey, std::size_t, ResultKeyHash> latestIndex;
+    auto keepLatest = [&latest, &latestIndex](const Entry &entry) {
+        auto found = latestIndex.find(entry.key);
+        if (found == latestIndex.end()) {
+            latestIndex[entry.key] = latest.size();
+            latest.push_back(entry);
+        } else if (improves(latest[found->second], entry)) {
+            latest[found->second] = entry;
+        }
+    };
+    {
+        MappedFile stored;
+        if (stored.open(path) && stored.getSize() >= (std::uint64_t)headerSize) {
+            const unsigned char *data = stored.getData();
+            std::uint64_t size = stored.getSize();
+            if (std::memcmp(data, cacheMagic, 4) == 0 &&
+                    get32(data + 4) == cacheVersion &&
+                    get32(data + 8) == SEMANTICS_VERSION) {
+                records = (size - headerSize) / recordSize;
+                for (std::uint64_t i = 0; i < records; i++) {
+                    const unsigned char *record = data + headerSize + i * recordSize;
+                    std::uint32_t state = get32(record + 20);
+                    if (state > nonTerminating)
+                        continue;
+                    Entry entry{{get64(record), get64(record + 8)},
+                                (gameState)state, (int)get32(record + 16)};
+                    remember(entry);
+                    keepLatest(entry);
+                }
+                // A write cut short leaves part of a result at the end,
+                // results appended after it would be misread.
+                rewrite = (size - headerSize) % recordSize != 0 ||
+                        records > 2 * latest.size();
+            }
+        }
+    }
+
+    if (rewrite) {
+        // Start over with one result per key, and the results in memory that
+        // the file did not have.
+        for (auto entry = entries.rbegin(); entry != entries.rend(); entry++) {
+            keepLatest(*entry);
+        }
+        std::vector<unsigned char> bytes = header();
+        for (const Entry &entry : latest) {
+            putRecord(bytes, entry.key, entry.state, entry.steps);
+        }
+        std::string temporary = path + ".tmp";
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write((const char *)bytes.data(), bytes.size());
+        out.close();
+        if (!out) {
+            error = "cannot write " + temporary;
+            return false;
+        }
+        // rename does not replace an existing file everywhere.
+        std::remove(path.c_str());
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            error = "cannot write " + path;
+            return false;
+        }
+    }
+
+    file.open(path, std::ios::binary | std::ios::app);
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool ResultCache::lookup(const ResultKey &key, int maxSteps, RunResult &result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found == index.end())
+        return false;
+    entries.splice(entries.begin(), entries, found->second);
+    const Entry &entry = *found->second;
+    if (entry.state != notEnded && entry.steps <= maxSteps) {
+        result = RunResult{entry.state, entry.steps};
+        return true;
+    }
+    // The run was still going at the limit.
+    if (entry.steps >= maxSteps) {
+        result = RunResult{notEnded, std::max(maxSteps, 0)};
+        return true;
+    }
+    return false;
+}
+
+void ResultCache::store(const ResultKey &key, int maxSteps,
+                        const RunResult &result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry entry{key, result.state,
+                result.state == notEnded ? std::min(result.steps, maxSteps)
+                                         : result.steps};
+    if (!remember(entry) || !file.is_open())
+        return;
+    std::vector<unsigned char> bytes;
+    putRecord(bytes, entry.key, entry.state, entry.steps);
+    file.write((const char *)bytes.data(), bytes.size());
+    // A server only stops on a signal, every result must be on disk by then.
+    file.flush();
+}
+
+void ResultCache::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    file.close();
+}
+
+int ResultCache::getSize() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+bool ResultCache::improves(const Entry &known, const Entry &entry) {
+    // A finished run never changes, an unfinished one only gets longer.
+    return known.state == notEnded &&
+            (entry.state != notEnded || entry.steps > known.steps);
+}
+
+bool ResultCache::remember(const Entry &entry) {
+    auto found = index.find(entry.key);
+    if (found != index.end()) {
+        entries.splice(entries.begin(), entries, found->second);
+        Entry &known = *found->second;
+        if (!improves(known, entry))
+            return false;
+        known.state = entry.state;
+        known.steps = entry.steps;
+        return true;
+    }
+    entries.push_front(entry);
+    index[entry.key] = entries.begin();
+    if ((int)entries.size() > capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    return true;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file resultcache.h
+ * @brief Header file for resultcache.cpp, remembers how programs end on
+ * levels so graders do not run the same submission twice.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "constants.h"
+#include "simulationcore.h"
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Content hash of a level and a compiled program.
+struct ResultKey {
+    std::uint64_t high;
+    std::uint64_t low;
+
+    bool operator==(const ResultKey &other) const {
+        return high == other.high && low == other.low;
+    }
+};
+
+struct ResultKeyHash {
+    std::size_t operator()(const ResultKey &key) const { return key.low; }
+};
+
+/**
+ * @brief resultKey Hash a level and a program. The program is hashed as the
+ * compiler sees it, so programs that compile to the same instructions share a
+ * key however their blocks were laid out.
+ * @param level
+ * @param program
+ * @return
+ */
+ResultKey resultKey(LevelView level, const std::vector<ProgramBlock> &program);
+
+/// Least recently used results in memory, optionally backed by a file that
+/// results are only ever appended to. Opening the file loads it into memory;
+/// a file written under another SEMANTICS_VERSION is started over. Results
+/// are kept per key as the final state and step count, which also answers
+/// for other step limits: a run that ended after n steps is unfinished under
+/// any smaller limit. Safe to use from several threads.
+class ResultCache {
+private:
+    struct Entry {
+        ResultKey key;
+        // notEnded if the run had not ended after steps steps.
+        gameState state;
+        int steps;
+    };
+
+    int capacity;
+    // Most recently used first.
+    std::list<Entry> entries;
+    std::unordered_map<ResultKey, std::list<Entry>::iterator, ResultKeyHash>
+            index;
+    std::ofstream file;
+    std::mutex mutex;
+
+public:
+    /**
+   * @brief ResultCache Create an empty cache.
+   * @param newCapacity Results kept in memory at most.
+   */
+    explicit ResultCache(int newCapacity = 100000);
+
+    ResultCache(const ResultCache &) = delete;
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    /**
+   * @brief open Load the results stored in a file and append new ones to it.
+   * The file is created if missing, and rewritten with one result per key if
+   * most of its results were superseded. Results that do not fit in memory
+   * stay in the file.
+   * @param path
+   * @param error Receives a message when the file cannot be used.
+   * @return Whether the file was opened.
+   */
+    bool open(const std::string &path, std::string &error);
+
+    /**
+   * @brief lookup Find the result of a run.
+   * @param key
+   * @param maxSteps Step limit of the run.
+   * @param result Receives what runUntilDone(maxSteps) would return.
+   * @return Whether the result is known.
+   */
+    bool lookup(const ResultKey &key, int maxSteps, RunResult &result);
+
+    /**
+   * @brief store Remember the result of a run.
+   * @param key
+   * @param maxSteps Step limit the run was given.
+   * @param result
+   */
+    void store(const ResultKey &key, int maxSteps, const RunResult &result);
+
+    /**
+   * @brief close Stop appending to the file, once no store is halfway
+   * through writing. Results are still kept in memory.
+   */
+    void close();
+
+    /**
+   * @brief getSize Get the number of results in memory.
+   * @return
+   */
+    int getSize();
+
+private:
+    /**
+   * @brief improves Whether a result for a key tells more than the one known.
+   * @param known
+   * @param entry
+   * @return
+   */
+    static bool improves(const Entry &known, const Entry &entry);
+
+    /**
+   * @brief remember Insert or update an entry as the most recently used one,
+   * evicting the least recently used past capacity.
+   * @param entry
+   * @return Whether the entry told anything new.
+   */
+    bool remember(const Entry &entry);
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = cheese-server
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+include(../core.pri)
+
+SOURCES += \
+    gradingserver.cpp \
+    main.cpp
+
+HEADERS += \
+    gradingserver.h
@@ -0,0 +1,267 @@
+/**
+ * @file gradingserver.cpp
+ * @brief Runs the jobs of the grading server and answers its connections.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "gradingserver.h"
+#include "multisimulation.h"
+#include "simulationcore.h"
+#include "textformat.h"
+#include <cstdlib>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const int MAX_LINE_LENGTH = 1 << 16;
+// Longest level number read, so it always fits an int.
+const int MAX_NUMBER_LENGTH = 9;
+
+const char *stateName(gameState state) {
+    switch (state) {
+    case won:
+        return "won";
+    case lost:
+        return "lost";
+    case nonTerminating:
+        return "nonterminating";
+    case notEnded:
+        break;
+    }
+    return "unfinished";
+}
+
+bool isNumber(const std::string &text) {
+    return !text.empty() && (int)text.size() <= MAX_NUMBER_LENGTH &&
+            text.find_first_not_of("0123456789") == std::string::npos;
+}
+
+} // namespace
+
+bool sendAll(int socket, const std::string &text) {
+    for (std::string::size_type sent = 0; sent < text.size();) {
+        ssize_t count = send(socket, text.data() + sent, text.size() - sent,
+                             MSG_NOSIGNAL);
+        if (count <= 0)
+            return false;
+        sent += count;
+    }
+    return true;
+}
+
+bool LevelCatalog::addPack(const std::string &path, std::string &error) {
+    std::unique_ptr<LevelPack> pack = std::make_unique<LevelPack>();
+    if (!pack->open(path, error))
+        return false;
+    packs.emplace_back(path, std::move(pack));
+    return true;
+}
+
+bool LevelCatalog::load(const std::string &name,
+                        std::vector<std::vector<MapTile>> &level,
+                        std::string &error) const {
+    if (isNumber(name))
+        return loadLevel(name, level, error);
+    std::string::size_type colon = name.rfind(':');
+    if (colon != std::string::npos) {
+        std::string packName = name.substr(0, colon);
+        std::string number = name.substr(colon + 1);
+        for (const auto &pack : packs) {
+            if (pack.first != packName)
+                continue;
+            int index = isNumber(number) ? std::atoi(number.c_str()) - 1 : -1;
+            if (index < 0 || index >= pack.second->getLevelCount() ||
+                    !pack.second->level(index, level)) {
+                error = "no level " + name;
+                return false;
+            }
+            return true;
+        }
+    }
+    error = "unknown level " + name +
+            ", expected a built-in level number or <pack>:<number>";
+    return false;
+}
+
+void JobSlots::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    slotFreed.wait(lock, [this]() { return available > 0; });
+    available--;
+}
+
+void JobSlots::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        available++;
+    }
+    slotFreed.notify_one();
+}
+
+Server::Server(int threads, int queue, int newInFlight, int newMaxConnections,
+               int newMaxSteps, ResultCache *newCache)
+    : pool(threads), slots(queue > 0 ? queue : 4 * pool.getThreadCount()),
+      inFlight(newInFlight > 0 ? newInFlight : 1),
+      maxConnections(newMaxConnections > 0 ? newMaxConnections : 1),
+      maxSteps(newMaxSteps), cache(newCache), connections(0) {}
+
+Connection::Connection(int newSocket, int newInFlightLimit,
+                       std::atomic<int> &newOpenConnections)
+    : socket(newSocket), inFlightLimit(newInFlightLimit),
+      openConnections(newOpenConnections), inFlight(0), reading(true),
+      broken(false) {}
+
+Connection::~Connection() {
+    close(socket);
+    openConnections--;
+}
+
+bool Connection::startJob() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return broken || inFlight < inFlightLimit; });
+    if (broken)
+        return false;
+    inFlight++;
+    return true;
+}
+
+void Connection::finishJob(std::string line) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        outbox.push_back(std::move(line));
+    }
+    changed.notify_all();
+}
+
+void Connection::stopReading() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reading = false;
+    }
+    changed.notify_all();
+}
+
+void Connection::sendResults() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() {
+            return !outbox.empty() || (!reading && inFlight == 0);
+        });
+        if (outbox.empty())
+            return;
+        std::deque<std::string> lines;
+        lines.swap(outbox);
+        bool sending = !broken;
+        lock.unlock();
+        std::string text;
+        for (const std::string &line : lines) {
+            text += line;
+        }
+        if (sending)
+            sending = sendAll(socket, text);
+        lock.lock();
+        broken = broken || !sending;
+        inFlight -= lines.size();
+        changed.notify_all();
+    }
+}
+
+std::string runJob(const Server &server, const std::string &line) {
+    std::istringstream fields(line);
+    std::string id;
+    std::string levelName;
+    long long maxSteps = -1;
+    fields >> id >> levelName >> maxSteps;
+    if (!fields || maxSteps < 0)
+        return (id.empty() ? "?" : id) +
+                "\terror\texpected <id> <level> <max-steps> <program...>\n";
+    if (maxSteps == 0 || maxSteps > server.maxSteps)
+        maxSteps = server.maxSteps;
+
+    std::string error;
+    std::vector<std::vector<MapTile>> level;
+    if (!server.levels.load(levelName, level, error))
+        return id + "\terror\t" + error + "\n";
+    std::string text;
+    std::getline(fields, text);
+    std::vector<ProgramBlock> program;
+    if (!parseProgram(text, program, error))
+        return id + "\terror\t" + error + "\n";
+
+    RunResult result{notEnded, 0};
+    ResultKey key{0, 0};
+    bool cached = false;
+    if (server.cache) {
+        key = resultKey(level, program);
+        cached = server.cache->lookup(key, maxSteps, result);
+    }
+    if (!cached) {
+        if (hasManyRobots(level)) {
+            MultiSimulation simulation(level, {program});
+            result = simulation.runUntilDone(maxSteps);
+        } else {
+            SimulationCore simulation(level, program);
+            result = simulation.runUntilDone(maxSteps);
+        }
+        if (server.cache)
+            server.cache->store(key, maxSteps, result);
+    }
+    return id + "\t" + stateName(result.state) + "\t" +
+            std::to_string(result.steps) + "\n";
+}
+
+void serveConnection(Server &server, std::shared_ptr<Connection> connection) {
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+        std::string::size_type newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.find_first_not_of(" \t") == std::string::npos)
+                continue;
+            if (!connection->startJob())
+                return;
+            server.slots.acquire();
+            server.pool.submit([&server, connection, line]() {
+                std::string result = runJob(server, line);
+                server.slots.release();
+                connection->finishJob(std::move(result));
+            });
+        }
+        if (buffer.size() > (std::string::size_type)MAX_LINE_LENGTH) {
+            if (connection->startJob())
+                connection->finishJob("?\terror\tline too long\n");
+            return;
+        }
+        ssize_t count = recv(connection->getSocket(), chunk, sizeof chunk, 0);
+        if (count <= 0)
+            return;
+        buffer.append(chunk, count);
+    }
+}
+
+bool acceptConnection(Server &server, int socket) {
+    // Every connection costs two threads, so their number is capped.
+    if (server.connections.fetch_add(1) >= server.maxConnections) {
+        server.connections--;
+        sendAll(socket, "?\terror\ttoo many connections\n");
+        close(socket);
+        return false;
+    }
+    auto connection = std::make_shared<Connection>(socket, server.inFlight,
+                                                   server.connections);
+    std::thread([&server, connection]() {
+        serveConnection(server, connection);
+        connection->stopReading();
+    }).detach();
+    std::thread([connection]() { connection->sendResults(); }).detach();
+    return true;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file gradingserver.h
+ * @brief Header file for gradingserver.cpp, the jobs and connections of the
+ * grading server.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef GRADINGSERVER_H
+#define GRADINGSERVER_H
+
+#include "constants.h"
+#include "levelpack.h"
+#include "resultcache.h"
+#include "threadpool.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Protocol, one job or result per line:
+//   job      <id> <level> <max-steps> <program...>
+//   result   <id> <state> <steps>      or      <id> error <message>
+// The id is any word the client picks, results come back in the order jobs
+// finish. A max-steps of 0 asks for the server's limit. A connection past
+// the server's limit gets a single "? error" line and is closed.
+
+/**
+ * @brief sendAll Write all of a text to a socket.
+ * @param socket
+ * @param text
+ * @return false once the socket fails.
+ */
+bool sendAll(int socket, const std::string &text);
+
+/// The levels jobs may name: built-in level numbers, and <pack>:<number> for
+/// the packs the server was started with. Nothing else is read from disk, so
+/// a client cannot make the server open a file.
+class LevelCatalog {
+private:
+    std::vector<std::pair<std::string, std::unique_ptr<LevelPack>>> packs;
+
+public:
+    /**
+   * @brief addPack Open a level pack for jobs to name by the given path.
+   * @param path
+   * @param error Receives a message when the file is not a level pack.
+   * @return Whether the pack was opened.
+   */
+    bool addPack(const std::string &path, std::string &error);
+
+    /**
+   * @brief load Get a level a job names. Safe to call from several threads.
+   * @param name
+   * @param level Receives the level.
+   * @param error Receives a message that only repeats the name.
+   * @return Whether the level exists.
+   */
+    bool load(const std::string &name, std::vector<std::vector<MapTile>> &level,
+              std::string &error) const;
+};
+
+/// Bounds the jobs queued or running on the pool. A connection waits here
+/// before it reads on, so a flood of jobs is held back by the socket instead
+/// of piling up in memory. A slot is freed as soon as its job has run, never
+/// later, so a client that does not read cannot hold on to slots.
+class JobSlots {
+private:
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    int available;
+
+public:
+    explicit JobSlots(int count) : available(count) {}
+
+    void acquire();
+    void release();
+};
+
+/// What every connection shares.
+struct Server {
+    WorkStealingPool pool;
+    JobSlots slots;
+    LevelCatalog levels;
+    int inFlight;
+    int maxConnections;
+    int maxSteps;
+    // nullptr without --cache.
+    ResultCache *cache;
+    // Connections accepted and not yet closed.
+    std::atomic<int> connections;
+
+    Server(int threads, int queue, int newInFlight, int newMaxConnections,
+           int newMaxSteps, ResultCache *newCache);
+};
+
+/// A client socket, read by one thread and written by another. Jobs never
+/// touch the socket: they leave their result in the outbox and the writer
+/// sends it, so a client that stops reading only stalls its own writer. The
+/// reader waits while inFlightLimit results are owed, which bounds the
+/// outbox. The socket is closed once the client stopped sending and the last
+/// result is sent, which tells the client every result has arrived.
+class Connection {
+private:
+    int socket;
+    int inFlightLimit;
+    // Decremented when the socket is closed.
+    std::atomic<int> &openConnections;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::string> outbox;
+    // Jobs read whose result has not been sent yet.
+    int inFlight;
+    bool reading;
+    // Whether a send failed, results are dropped from then on.
+    bool broken;
+
+public:
+    Connection(int newSocket, int newInFlightLimit,
+               std::atomic<int> &newOpenConnections);
+    ~Connection();
+
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+
+    int getSocket() const { return socket; }
+
+    /**
+   * @brief startJob Wait until another result may be owed, and count it.
+   * @return false once the client can no longer be answered.
+   */
+    bool startJob();
+
+    /**
+   * @brief finishJob Queue the result of a started job for the writer.
+   * @param line
+   */
+    void finishJob(std::string line);
+
+    /**
+   * @brief stopReading Tell the writer no more jobs are coming.
+   */
+    void stopReading();
+
+    /**
+   * @brief sendResults Writer loop, returns once every result is sent.
+   */
+    void sendResults();
+};
+
+/**
+ * @brief runJob Run one job line.
+ * @param server
+ * @param line
+ * @return The result line.
+ */
+std::string runJob(const Server &server, const std::string &line);
+
+/**
+ * @brief serveConnection Reader loop, submits every job line of a client to
+ * the pool and returns once the client stopped sending.
+ * @param server
+ * @param connection
+ */
+void serveConnection(Server &server, std::shared_ptr<Connection> connection);
+
+/**
+ * @brief acceptConnection Start the reader and writer of a new client, or
+ * turn it away when the server has maxConnections open already.
+ * @param server
+ * @param socket Owned from here on.
+ * @return Whether the client was accepted.
+ */
+bool acceptConnection(Server &server, int socket);
+
+#endif // GRADINGSERVER_H
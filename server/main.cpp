@@ -0,0 +1,202 @@
+/**
+ * @file main.cpp
+ * @brief Grading server that runs programs submitted over a loopback socket
+ * on a thread pool, and a client to submit them from the command line.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "gradingserver.h"
+#include <arpa/inet.h>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// The protocol is described in gradingserver.h.
+namespace {
+
+const int DEFAULT_PORT = 7171;
+const int DEFAULT_MAX_STEPS = 1000000;
+const int DEFAULT_IN_FLIGHT = 64;
+const int DEFAULT_CONNECTIONS = 64;
+
+void printUsage() {
+    std::cerr << "usage: cheese-server [--port N] [--threads N] [--queue N] "
+                 "[--in-flight N]\n"
+                 "                     [--connections N] [--max-steps N] "
+                 "[--cache <file>]\n"
+                 "                     [--pack <file>]...\n"
+                 "       cheese-server --submit [--port N]\n"
+                 "  Serves on 127.0.0.1. Each line sent is a job:\n"
+                 "    <id> <level> <max-steps> <program...>\n"
+                 "  and each job is answered as soon as it finishes with\n"
+                 "    <id>\t<state>\t<steps>   or   <id>\terror\t<message>\n"
+                 "  <level> is a built-in level number or <pack>:<number> for "
+                 "a --pack file; no\n"
+                 "  other file is read. A max-steps of 0, or one above "
+                 "--max-steps (default\n"
+                 "  1000000), runs to --max-steps.\n"
+                 "  --queue is the number of jobs queued or running at once "
+                 "(default 4 per thread);\n"
+                 "  past it the server stops reading until a job finishes.\n"
+                 "  --in-flight is the number of jobs one connection may have "
+                 "unanswered (default\n"
+                 "  64); past it the server stops reading that connection "
+                 "until it takes results.\n"
+                 "  --connections is the number of clients served at once "
+                 "(default 64); past it\n"
+                 "  a client gets a single error line.\n"
+                 "  --cache keeps results in a file, as cheese-cli does.\n"
+                 "  --submit sends the jobs read from standard input and "
+                 "prints the results.\n";
+}
+
+int serve(int port, int threads, int queue, int inFlight, int connections,
+          int maxSteps, const std::string &cachePath,
+          const std::vector<std::string> &packPaths) {
+    ResultCache cache;
+    std::string error;
+    if (!cachePath.empty() && !cache.open(cachePath, error)) {
+        std::cerr << "cheese-server: " << error << "\n";
+        return 1;
+    }
+
+    // SIGINT and SIGTERM are blocked in every thread started from here on,
+    // and this one waits for them to close the cache between two results.
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+    std::thread([&cache, stopSignals]() {
+        int received = 0;
+        sigwait(&stopSignals, &received);
+        cache.close();
+        std::cerr << "cheese-server: stopped\n";
+        std::_Exit(0);
+    }).detach();
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    if (listener >= 0)
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof reuse);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    // Loopback only, the server is not meant to face a network.
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (listener < 0 ||
+            bind(listener, (sockaddr *)&address, sizeof address) != 0 ||
+            listen(listener, 64) != 0) {
+        std::cerr << "cheese-server: cannot listen on port " << port << "\n";
+        return 1;
+    }
+
+    Server server(threads, queue, inFlight, connections, maxSteps,
+                  cachePath.empty() ? nullptr : &cache);
+    for (const std::string &path : packPaths) {
+        if (!server.levels.addPack(path, error)) {
+            std::cerr << "cheese-server: " << error << "\n";
+            return 1;
+        }
+    }
+    std::cerr << "cheese-server: listening on 127.0.0.1:" << port << " with "
+              << server.pool.getThreadCount() << " threads\n";
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+            continue;
+        acceptConnection(server, client);
+    }
+}
+
+int submit(int port) {
+    int connection = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connection < 0 ||
+            connect(connection, (sockaddr *)&address, sizeof address) != 0) {
+        std::cerr << "cheese-server: no server on port " << port << "\n";
+        return 1;
+    }
+
+    // Print results while still sending, the server stops reading while its
+    // queue is full and only goes on once results are taken.
+    std::thread receiver([connection]() {
+        char chunk[4096];
+        ssize_t count;
+        while ((count = recv(connection, chunk, sizeof chunk, 0)) > 0) {
+            std::cout.write(chunk, count);
+        }
+        std::cout.flush();
+    });
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!sendAll(connection, line + "\n"))
+            break;
+    }
+    // The server closes the socket after the last result.
+    shutdown(connection, SHUT_WR);
+    receiver.join();
+    close(connection);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int port = DEFAULT_PORT;
+    int threads = 0;
+    int queue = 0;
+    int inFlight = DEFAULT_IN_FLIGHT;
+    int connections = DEFAULT_CONNECTIONS;
+    int maxSteps = DEFAULT_MAX_STEPS;
+    bool submitting = false;
+    std::string cachePath;
+    std::vector<std::string> packPaths;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--port" && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (argument == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (argument == "--queue" && i + 1 < argc) {
+            queue = std::atoi(argv[++i]);
+        } else if (argument == "--in-flight" && i + 1 < argc) {
+            inFlight = std::atoi(argv[++i]);
+        } else if (argument == "--connections" && i + 1 < argc) {
+            connections = std::atoi(argv[++i]);
+        } else if (argument == "--max-steps" && i + 1 < argc) {
+            maxSteps = std::atoi(argv[++i]);
+        } else if (argument == "--cache" && i + 1 < argc) {
+            cachePath = argv[++i];
+        } else if (argument == "--pack" && i + 1 < argc) {
+            packPaths.push_back(argv[++i]);
+        } else if (argument == "--submit") {
+            submitting = true;
+        } else {
+            printUsage();
+            return argument == "-h" || argument == "--help" ? 0 : 1;
+        }
+    }
+    if (submitting)
+        return submit(port);
+    if (maxSteps < 1 || inFlight < 1 || connections < 1) {
+        printUsage();
+        return 1;
+    }
+    return serve(port, threads, queue, inFlight, connections, maxSteps,
+                 cachePath, packPaths);
+}
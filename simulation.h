@@ -12,45 +12,61 @@
 #define SIMULATION_H
 
 #include "constants.h"
+#include "simulationcore.h"
 #include <QObject>
 #include <QPoint>
 #include <vector>
 
+/// Qt adapter around SimulationCore, notifies the editor which block is
+/// running.
 class Simulation : public QObject {
     Q_OBJECT
 private:
-    gameState gameState;
-    int width;
-    int height;
-    QPoint cheesePos;
-
-    QPoint robotPos;
-    direction robotDirection;
-
-    std::vector<ProgramBlock> program;
-    int tickCount;
-    int currentBlock;
-    int level;
-    std::map<int, int> ifWhileToEnd;
-    std::map<int, int> endToIfWhile;
+    SimulationCore core;
 
 public:
-    std::vector<std::vector<MapTile>> map;
-
     /**
    * @brief Simulation Constructs a new simulation.
    * @param newMap
    * @param newProgram
    * @param parent
    */
-    Simulation(std::vector<std::vector<MapTile>> newMap,
-               std::vector<ProgramBlock> newProgram, QObject *parent = 0);
+    Simulation(LevelView newMap, std::vector<ProgramBlock> newProgram,
+               QObject *parent = 0);
+
+    /**
+   * @brief Simulation Go on from a run stepped elsewhere, such as one handed
+   * over by a SimulationWorker.
+   * @param newCore Should keep history so its steps can be undone.
+   * @param parent
+   */
+    explicit Simulation(SimulationCore newCore, QObject *parent = 0);
 
     /**
    * @brief step Execute next block.
    */
     void step();
 
+    /**
+   * @brief stepBack Undo the last step and report the block that is now the
+   * last one run.
+   * @return false at the start of the run.
+   */
+    bool stepBack();
+
+    /**
+   * @brief seekTick Jump to any earlier or later tick of the run.
+   * @param tick
+   * @return Whether the tick was reached.
+   */
+    bool seekTick(int tick);
+
+    /**
+   * @brief getTickCount Get the number of steps executed so far.
+   * @return
+   */
+    int getTickCount();
+
     /**
    * @brief getRobotPos Get robot's position.
    * @return
@@ -93,30 +109,19 @@ public:
    */
     std::vector<std::vector<MapTile>> getMap();
 
-private:
-    /**
-   * @brief setLost Set the game state to lost.
-   */
-    void setLost();
-
     /**
-   * @brief checkInBounds Check whether the given point is in the bound of map.
+   * @brief getChanges Get the tiles changed by the last step.
    * @return
    */
-    bool checkInBounds(QPoint);
+    const std::vector<TileChange> &getChanges();
 
     /**
-   * @brief checkCondition Check if the conditional statement satisfied.
-   * @return
+   * @brief setTrace Record every following step into a trace, nullptr stops
+   * recording.
+   * @param writer Not owned.
    */
-    bool checkCondition(bool, ProgramBlock);
+    void setTrace(TraceWriter *writer);
 
-    /**
-   * @brief getFacingPoint Get the facing point.
-   * @param offset
-   * @return
-   */
-    QPoint getFacingPoint(int offset = 1);
 signals:
 
     /**
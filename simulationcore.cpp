@@ -0,0 +1,820 @@
+/**
+ * @file simulationcore.cpp
+ * @brief The tiny simulation program, free of any Qt dependency.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "simulationcore.h"
+#include "blockprofile.h"
+#include "constants.h"
+#include "trace.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+// Steps kept in the undo log, older steps are reached through checkpoints.
+const int UNDO_LOG_LIMIT = 4096;
+// Checkpoints kept before every other one is dropped.
+const int MAX_CHECKPOINTS = 64;
+const int FIRST_CHECKPOINT_INTERVAL = 1024;
+// Transitions remembered per run, later stretches are run normally.
+const int TRANSITION_LIMIT = 1 << 16;
+// Fewest instructions a stretch must run to be worth remembering.
+const int MIN_SEGMENT_LENGTH = 4;
+// Steps looked ahead for repeated states the first time step() needs to.
+const int FIRST_LOOK_AHEAD = 1024;
+} // namespace
+
+SimulationCore::SimulationCore(LevelView newMap,
+                               std::vector<ProgramBlock> newProgram)
+    : state(notEnded), grid(newMap), cheeseCell(-1), robotCell(-1),
+      robotDirection(east), code(compileProgram(newProgram)),
+      programSize(newProgram.size()) {
+    // Without a start tile the robot starts in the top left corner.
+    robotCell = grid.index(0, 0);
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (newMap.at(x, y) == start) {
+                robotCell = grid.index(x, y);
+            }
+            if (newMap.at(x, y) == cheese) {
+                cheeseCell = grid.index(x, y);
+            }
+        }
+    }
+
+    initialize();
+}
+
+SimulationCore::SimulationCore(const TileGrid &board, int newRobotCell,
+                               direction newDirection, int newCheeseCell,
+                               std::vector<ProgramBlock> newProgram)
+    : state(notEnded), grid(board), cheeseCell(newCheeseCell),
+      robotCell(newRobotCell), robotDirection(newDirection),
+      code(compileProgram(newProgram)), programSize(newProgram.size()) {
+    initialize();
+}
+
+void SimulationCore::initialize() {
+    tickCount = 0;
+    pc = 0;
+    currentBlock = 0;
+
+    fused = fuseProgram(code);
+    fusedIndex.assign(code.size() + 1, -1);
+    for (unsigned long long i = 0; i < fused.size(); i++) {
+        fusedIndex[fused[i].first] = i;
+    }
+    fusedIndex[code.size()] = fused.size();
+
+    // A "while not" loop over moves alone walks the robot in a straight line
+    // until it faces what the condition tests for, or gets blocked.
+    straightMoves.assign(code.size() + 1, 0);
+    for (unsigned long long head = 0; head < code.size(); head++) {
+        int end = code[head].target - 1;
+        if (code[head].op != opBranch || !code[head].negate ||
+                end <= (int)head + 1 || code[end].op != opJump ||
+                code[end].target != (int)head)
+            continue;
+        bool movesOnly = true;
+        for (int i = head + 1; i < end; i++) {
+            movesOnly = movesOnly && code[i].op == opMove;
+        }
+        if (movesOnly)
+            straightMoves[head] = end - head - 1;
+    }
+    obstacles.clear();
+
+    blockHash = 0;
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (grid.at(grid.index(x, y)) & tileBlock) {
+                blockHash ^= blockKey(grid.index(x, y));
+            }
+        }
+    }
+    detectCycles = true;
+    seenStates.emplace(getStateHash(), tickCount);
+    knownUntil = -1;
+    repeatTick = -1;
+    origin.reset();
+    trace = nullptr;
+    profile = nullptr;
+    transitions = std::make_shared<TransitionTable>();
+    shortSegment.assign(code.size() + 1, false);
+    recordHistory = false;
+    checkpointInterval = FIRST_CHECKPOINT_INTERVAL;
+}
+
+void SimulationCore::step() {
+    changes.clear();
+    if (state != notEnded)
+        return;
+    if (recordHistory) {
+        undoLog.push_back(UndoRecord{pc, robotCell, robotDirection, cheeseCell,
+                                     state, currentBlock, false, 0});
+    }
+
+    if (pc == (int)code.size()) {
+        tickCount++;
+        currentBlock = programSize;
+        setLost();
+    } else {
+        const Instruction &instruction = code[pc];
+        if (profile) {
+            profile->record(instruction.block,
+                            instruction.op == opBranch
+                                    ? (int)checkCondition(instruction)
+                                    : -1);
+        }
+        execute(instruction);
+
+        // The run is deterministic, so reaching a state twice means it
+        // loops. Up to knownUntil a look ahead already found out, past it
+        // look twice as far from origin.
+        if (detectCycles && state == notEnded) {
+            if (origin && tickCount > knownUntil) {
+                int ahead = std::max(knownUntil - origin->tickCount,
+                                     FIRST_LOOK_AHEAD);
+                lookFurther((int)std::min<long long>(
+                        (long long)knownUntil + ahead, INT_MAX));
+            }
+            if (tickCount <= knownUntil) {
+                if (tickCount == repeatTick)
+                    state = nonTerminating;
+            } else if (!seenStates.emplace(getStateHash(), tickCount).second) {
+                state = nonTerminating;
+            } else {
+                if (recordHistory)
+                    undoLog.back().addedState = true;
+                // Only remember states up to where runUntilDone can start,
+                // the rest are looked ahead for.
+                if (fusedIndex[pc] >= 0)
+                    setOrigin();
+            }
+        }
+    }
+
+    if (recordHistory)
+        saveHistory();
+    // Steps replayed after stepping back are already in the trace.
+    if (trace && tickCount > trace->getLastTick())
+        trace->record(*this);
+}
+
+void SimulationCore::execute(const Instruction &instruction) {
+    switch (instruction.op) {
+    case opMoveN:
+        for (int i = 0; i < instruction.count; i++) {
+            tickCount++;
+            pc = instruction.first + i + 1;
+            currentBlock = code[pc - 1].block;
+            if (!moveRobot()) {
+                if (state != notEnded)
+                    return;
+                // Blocked, the remaining moves change nothing.
+                int remaining = instruction.count - i - 1;
+                tickCount += remaining;
+                pc += remaining;
+                currentBlock = code[pc - 1].block;
+                return;
+            }
+        }
+        return;
+    case opRotate:
+        tickCount += instruction.count;
+        pc = instruction.first + instruction.count;
+        currentBlock = code[pc - 1].block;
+        robotDirection = rotate(robotDirection, instruction.target);
+        return;
+    default:
+        break;
+    }
+
+    tickCount++;
+    currentBlock = instruction.block;
+    pc = instruction.first + 1;
+
+    switch (instruction.op) {
+    case opMove:
+        moveRobot();
+        break;
+    case opTurnLeft:
+        robotDirection = rotate(robotDirection, 3);
+        break;
+    case opTurnRight:
+        robotDirection = rotate(robotDirection, 1);
+        break;
+    case opEat:
+        if (cheeseCell == robotCell) {
+            setCell(cheeseCell, grid.at(cheeseCell) & ~tileCheese);
+            cheeseCell = -1;
+            state = won;
+        }
+        break;
+    case opBranch:
+        if (!checkCondition(instruction)) {
+            pc = instruction.target;
+        }
+        break;
+    case opJump:
+        pc = instruction.target;
+        break;
+    default:
+        break;
+    }
+}
+
+bool SimulationCore::moveRobot() {
+    int offset = grid.offset(robotDirection);
+    int newCell = robotCell + offset;
+    unsigned char facing = grid.at(newCell);
+    int newBoxCell = newCell + offset;
+    unsigned char behind = facing & tileBlock ? grid.at(newBoxCell) : 0;
+
+    switch (moveOutcome(facing, behind)) {
+    case moveWalks:
+        robotCell = newCell;
+        return true;
+    case moveFalls:
+        setLost();
+        return false;
+    case movePushes:
+        setCell(newBoxCell, behind | tileBlock);
+        robotCell = newCell;
+        setCell(newCell, facing & ~tileBlock);
+        return true;
+    case moveDropsBlock:
+        robotCell = newCell;
+        setCell(newCell, facing & ~tileBlock);
+        return true;
+    case moveBlocked:
+        break;
+    }
+    return false;
+}
+
+RunResult SimulationCore::runUntilDone(int maxSteps) {
+    // Finish a fused run that step() left half done. Traces, profiles and
+    // the undo log need every step, so recording runs take the slow path all
+    // the way.
+    while (state == notEnded && tickCount < maxSteps &&
+           (fusedIndex[pc] < 0 || trace || profile || recordHistory)) {
+        step();
+    }
+    if (state != notEnded || tickCount >= maxSteps)
+        return RunResult{state, tickCount};
+    if (detectCycles && origin && knownUntil < maxSteps)
+        lookFurther(maxSteps);
+    if (detectCycles && tickCount < knownUntil) {
+        // An earlier call already looked this far ahead.
+        advanceTo(std::min(knownUntil, maxSteps));
+        if (state == notEnded && tickCount == repeatTick)
+            state = nonTerminating;
+        if (state != notEnded || tickCount >= maxSteps)
+            return RunResult{state, tickCount};
+    }
+
+    // Keep a copy to replay from, without the history of earlier states.
+    std::unordered_map<std::uint64_t, int> earlier;
+    earlier.swap(seenStates);
+    SimulationCore entry = *this;
+    earlier.swap(seenStates);
+
+    // Every loop passes through the target of an end while jump, so only
+    // states there are remembered, with the step they were reached on.
+    std::unordered_map<std::uint64_t, int> loopStates;
+    std::vector<int> headTicks;
+    int period = 0;
+    int before = tickCount;
+    // Whether straight loops were skipped, leaving loop heads unremembered.
+    bool skipped = false;
+    while (state == notEnded && tickCount < maxSteps) {
+        if (skipStraightLoop(maxSteps)) {
+            skipped = true;
+        } else if (!runSegment(maxSteps)) {
+            break;
+        }
+        if (!detectCycles)
+            continue;
+        auto inserted = loopStates.emplace(getStateHash(), tickCount);
+        if (!inserted.second) {
+            period = tickCount - inserted.first->second;
+            // The loop is entered no earlier than the loop head before the
+            // repeated one, a head further inside would have repeated first.
+            // That only holds when every loop head was remembered.
+            auto head = std::lower_bound(headTicks.begin(), headTicks.end(),
+                                         inserted.first->second);
+            if (head != headTicks.begin() && !skipped)
+                before = *(head - 1);
+            break;
+        }
+        headTicks.push_back(tickCount);
+    }
+
+    if (period > 0) {
+        findFirstRepeat(entry, period, before);
+    } else if (state == notEnded && detectCycles) {
+        // The step limit was hit, but a loop may have closed before it with
+        // its heads only coming back after the limit. Every state since the
+        // last head is then inside the loop, so look for its period on a
+        // copy running on past the limit, and only replay when there is one.
+        earlier.swap(seenStates);
+        SimulationCore ahead = *this;
+        earlier.swap(seenStates);
+        period = ahead.findPeriod(maxSteps);
+        // Nothing repeats up to the limit, remember that for later steps.
+        int repeat = -1;
+        int known = ahead.getGameState() == notEnded ? maxSteps : INT_MAX;
+        if (period > 0) {
+            earlier.swap(seenStates);
+            SimulationCore atLimit = *this;
+            earlier.swap(seenStates);
+            findFirstRepeat(entry, period, entry.getTickCount());
+            if (tickCount > maxSteps) {
+                // The first repeat comes after the limit after all.
+                repeat = tickCount;
+                known = tickCount;
+                earlier.swap(seenStates);
+                *this = atLimit;
+                earlier.swap(seenStates);
+            }
+        }
+        if (state == notEnded) {
+            knownUntil = known;
+            repeatTick = repeat;
+            // Later steps look further ahead from where this call started,
+            // which needs the states reached before it and no others.
+            auto start = std::make_shared<SimulationCore>(entry);
+            start->seenStates.swap(seenStates);
+            origin = start;
+        }
+    }
+    while (state == notEnded && tickCount < maxSteps) {
+        step();
+    }
+    return RunResult{state, tickCount};
+}
+
+bool SimulationCore::runSegment(int maxSteps) {
+    TransitionKey key{pc, robotCell, robotDirection, blockHash};
+    if (!shortSegment[pc]) {
+        auto known = transitions->find(key);
+        if (known != transitions->end()) {
+            const Transition &next = known->second;
+            if (tickCount + next.ticks > maxSteps)
+                return false;
+            changes.clear();
+            pc = next.pc;
+            robotCell = next.robotCell;
+            robotDirection = next.robotDirection;
+            tickCount += next.ticks;
+            currentBlock = next.currentBlock;
+            return true;
+        }
+    }
+
+    int startTick = tickCount;
+    int length = 0;
+    while (true) {
+        if (pc == (int)code.size()) {
+            if (tickCount < maxSteps)
+                step();
+            return false;
+        }
+        const Instruction &instruction = fused[fusedIndex[pc]];
+        if (tickCount + instruction.count > maxSteps)
+            return false;
+        changes.clear();
+        execute(instruction);
+        length++;
+        if (state != notEnded)
+            return false;
+        if (instruction.op == opJump)
+            break;
+    }
+    if (length < MIN_SEGMENT_LENGTH) {
+        shortSegment[key.pc] = true;
+        return true;
+    }
+    // The map is decided by where the blocks are, so a stretch that left
+    // them in place runs the same way every time it starts from this key.
+    if (blockHash == key.mapHash && (int)transitions->size() < TRANSITION_LIMIT) {
+        transitions->emplace(key, Transition{pc, robotCell, robotDirection,
+                                             tickCount - startTick,
+                                             currentBlock});
+    }
+    return true;
+}
+
+bool SimulationCore::skipStraightLoop(int maxSteps) {
+    int moves = straightMoves[pc];
+    if (moves == 0)
+        return false;
+    const Instruction &head = code[pc];
+    int offset = grid.offset(robotDirection);
+    int free = obstacles.freeAhead(grid, robotCell, robotDirection);
+    // Free cells never hold what a "while not" tests for, except the cheese.
+    int iterations = free / moves;
+    if ((head.mask & tileCheese) && cheeseCell >= 0 &&
+            (cheeseCell - robotCell) % offset == 0) {
+        int distance = (cheeseCell - robotCell) / offset;
+        if (distance >= 1 && distance <= free && (distance - 1) % moves == 0)
+            iterations = std::min(iterations, (distance - 1) / moves);
+    }
+    // Each iteration is the head, the moves and the end while.
+    iterations = std::min(iterations, (maxSteps - tickCount) / (moves + 2));
+    if (iterations <= 0)
+        return false;
+
+    changes.clear();
+    robotCell += iterations * moves * offset;
+    tickCount += iterations * (moves + 2);
+    currentBlock = code[head.target - 1].block;
+    return true;
+}
+
+int SimulationCore::findPeriod(int steps) {
+    detectCycles = false;
+    while (state == notEnded && fusedIndex[pc] < 0) {
+        step();
+    }
+    int end = tickCount + std::min(steps, INT_MAX - tickCount);
+    if (state != notEnded || !(skipStraightLoop(end) || runSegment(end)))
+        return 0;
+
+    // A loop head, where the fast path stops after every end while jump
+    // except inside skipped straight loops.
+    int headTick = tickCount;
+    int headPc = pc;
+    int headCell = robotCell;
+    direction headDirection = robotDirection;
+    std::uint64_t headBlocks = blockHash;
+    end = headTick + std::min(steps, INT_MAX - headTick);
+    while (state == notEnded) {
+        int fromCell = robotCell;
+        int fromTick = tickCount;
+        if (skipStraightLoop(end)) {
+            if (pc != headPc || robotDirection != headDirection ||
+                    blockHash != headBlocks)
+                continue;
+            // The skipped iterations end on the head cells in between.
+            int moves = straightMoves[pc];
+            int stride = moves * grid.offset(robotDirection);
+            int distance = headCell - fromCell;
+            int iteration = distance / stride;
+            if (distance % stride == 0 && iteration >= 1 &&
+                    iteration <= (robotCell - fromCell) / stride)
+                return fromTick + iteration * (moves + 2) - headTick;
+        } else if (!runSegment(end)) {
+            return 0;
+        } else if (pc == headPc && robotCell == headCell &&
+                   robotDirection == headDirection && blockHash == headBlocks) {
+            return tickCount - headTick;
+        }
+    }
+    return 0;
+}
+
+void SimulationCore::setOrigin() {
+    auto start = std::make_shared<SimulationCore>(*this);
+    start->trace = nullptr;
+    start->profile = nullptr;
+    start->setHistory(false);
+    origin = start;
+    knownUntil = tickCount;
+    repeatTick = -1;
+}
+
+void SimulationCore::lookFurther(int tick) {
+    SimulationCore probe = *origin;
+    RunResult end = probe.runUntilDone(tick);
+    switch (end.state) {
+    case notEnded:
+        knownUntil = probe.knownUntil;
+        repeatTick = probe.repeatTick;
+        break;
+    case nonTerminating:
+        knownUntil = end.steps;
+        repeatTick = end.steps;
+        break;
+    case won:
+    case lost:
+        // A run that ends never repeats a state.
+        knownUntil = INT_MAX;
+        repeatTick = -1;
+        break;
+    }
+}
+
+void SimulationCore::advanceTo(int tick) {
+    while (state == notEnded && tickCount < tick && fusedIndex[pc] < 0) {
+        step();
+    }
+    while (state == notEnded && tickCount < tick &&
+           (skipStraightLoop(tick) || runSegment(tick))) {
+    }
+    while (state == notEnded && tickCount < tick) {
+        step();
+    }
+}
+
+RunResult SimulationCore::runToFirstRepeat(int period) {
+    std::unordered_map<std::uint64_t, int> earlier;
+    earlier.swap(seenStates);
+    SimulationCore entry = *this;
+    earlier.swap(seenStates);
+    findFirstRepeat(entry, period, tickCount);
+    return RunResult{state, tickCount};
+}
+
+void SimulationCore::findFirstRepeat(const SimulationCore &entry, int period,
+                                     int before) {
+    SimulationCore trailing = entry;
+    trailing.detectCycles = false;
+    trailing.trace = nullptr;
+    // Nothing repeats before the loop is entered, skip there through the
+    // transitions the first pass remembered.
+    trailing.advanceTo(before);
+    SimulationCore leading = trailing;
+    leading.advanceTo(before + period);
+
+    // States repeat from the first step the two copies agree on, the loop
+    // entry. If that is where this call started, the loop may have been
+    // entered before it, so the first repeat is of an earlier state.
+    std::unordered_map<std::uint64_t, int> loopEntry;
+    const std::unordered_map<std::uint64_t, int> *repeats = &loopEntry;
+    if (trailing.getStateHash() != leading.getStateHash()) {
+        do {
+            trailing.step();
+            leading.step();
+        } while (trailing.getStateHash() != leading.getStateHash());
+    } else if (before == entry.getTickCount()) {
+        repeats = &seenStates;
+    }
+    loopEntry.emplace(trailing.getStateHash(), trailing.getTickCount());
+    do {
+        trailing.step();
+    } while (!repeats->count(trailing.getStateHash()));
+
+    std::unordered_map<std::uint64_t, int> earlier;
+    earlier.swap(seenStates);
+    TraceWriter *writer = trace;
+    *this = trailing;
+    earlier.swap(seenStates);
+    trace = writer;
+    detectCycles = true;
+    state = nonTerminating;
+}
+
+std::size_t SimulationCore::TransitionKeyHash::operator()(
+        const TransitionKey &key) const {
+    return key.mapHash ^ robotKey(key.pc, key.robotCell, key.robotDirection);
+}
+
+void SimulationCore::setLost() {
+    state = lost;
+    robotCell = -1;
+}
+
+bool SimulationCore::checkCondition(const Instruction &instruction) const {
+    unsigned char facing = grid.at(robotCell + grid.offset(robotDirection));
+    return conditionHolds(facing, instruction.mask, instruction.negate);
+}
+
+void SimulationCore::setCell(int cell, unsigned char bits) {
+    if (recordHistory) {
+        undoCells.emplace_back(cell, grid.at(cell));
+        undoLog.back().cellCount++;
+    }
+    writeCell(cell, bits);
+}
+
+void SimulationCore::writeCell(int cell, unsigned char bits) {
+    if ((grid.at(cell) ^ bits) & tileBlock) {
+        blockHash ^= blockKey(cell);
+        obstacles.invalidate(grid, cell);
+    }
+    grid.set(cell, bits);
+    int x = grid.getX(cell);
+    int y = grid.getY(cell);
+    changes.push_back(TileChange{x, y, grid.tileAt(x, y)});
+}
+
+Point SimulationCore::toPoint(int cell) const {
+    if (cell < 0)
+        return Point{-1, -1};
+    return Point{grid.getX(cell), grid.getY(cell)};
+}
+
+Point SimulationCore::getCheesePos() const { return toPoint(cheeseCell); }
+Point SimulationCore::getRobotPos() const { return toPoint(robotCell); }
+int SimulationCore::getCurrentBlock() const { return currentBlock; }
+int SimulationCore::getTickCount() const { return tickCount; }
+
+std::string SimulationCore::toString() const {
+    std::string mapString = "";
+    for (int y = 0; y < grid.getHeight(); y++) {
+        if (y > 0)
+            mapString.append("\n");
+        for (int x = 0; x < grid.getWidth(); x++) {
+            int cell = grid.index(x, y);
+            if (robotCell == cell) {
+                switch (robotDirection) {
+                case north:
+                    mapString.append("^");
+                    continue;
+                case south:
+                    mapString.append("v");
+                    continue;
+                case east:
+                    mapString.append(">");
+                    continue;
+                case west:
+                    mapString.append("<");
+                    continue;
+                }
+            }
+            switch (grid.tileAt(x, y)) {
+            case cheese:
+                mapString.append("C");
+                break;
+            case ground:
+            case start:
+                mapString.append("*");
+                break;
+            case pit:
+                mapString.append("0");
+                break;
+            case block:
+                mapString.append("@");
+                break;
+            case wall:
+                mapString.append("#");
+                break;
+            }
+        }
+    }
+    return mapString;
+}
+
+std::vector<std::vector<MapTile>> SimulationCore::getMap() const {
+    return grid.toMap();
+}
+
+const std::vector<TileChange> &SimulationCore::getChanges() const {
+    return changes;
+}
+
+std::uint64_t SimulationCore::getStateHash() const {
+    return blockHash ^ robotKey(pc, robotCell, robotDirection);
+}
+
+std::uint64_t SimulationCore::getBoardHash() const {
+    return blockHash ^ robotKey(0, robotCell, robotDirection);
+}
+
+bool SimulationCore::atProgramEnd() const { return pc == (int)code.size(); }
+
+void SimulationCore::setHistory(bool enabled) {
+    recordHistory = enabled;
+    undoLog.clear();
+    undoCells.clear();
+    checkpoints.clear();
+    checkpointInterval = FIRST_CHECKPOINT_INTERVAL;
+    if (enabled)
+        checkpoints.push_back(makeCheckpoint());
+}
+
+bool SimulationCore::stepBack() {
+    if (!undoLog.empty()) {
+        changes.clear();
+        undoStep();
+        return true;
+    }
+    return tickCount > 0 && seekTick(tickCount - 1);
+}
+
+bool SimulationCore::seekTick(int tick) {
+    if (!recordHistory || tick < checkpoints.front().tick)
+        return false;
+    changes.clear();
+    while (tickCount > tick && !undoLog.empty()) {
+        undoStep();
+    }
+
+    if (tickCount > tick) {
+        // Further back than the undo log, replay from a checkpoint.
+        while (checkpoints.back().tick > tick) {
+            checkpoints.pop_back();
+        }
+        const Checkpoint &checkpoint = checkpoints.back();
+        grid = checkpoint.grid;
+        obstacles.clear();
+        pc = checkpoint.pc;
+        robotCell = checkpoint.robotCell;
+        robotDirection = checkpoint.robotDirection;
+        cheeseCell = checkpoint.cheeseCell;
+        state = checkpoint.state;
+        currentBlock = checkpoint.currentBlock;
+        blockHash = checkpoint.blockHash;
+        tickCount = checkpoint.tick;
+        undoLog.clear();
+        undoCells.clear();
+        for (auto seen = seenStates.begin(); seen != seenStates.end();) {
+            if (seen->second > tickCount) {
+                seen = seenStates.erase(seen);
+            } else {
+                seen++;
+            }
+        }
+    }
+
+    while (tickCount < tick && state == notEnded) {
+        step();
+    }
+    return tickCount == tick;
+}
+
+void SimulationCore::undoStep() {
+    const UndoRecord &record = undoLog.back();
+    if (record.addedState) {
+        seenStates.erase(getStateHash());
+    }
+    for (int i = 0; i < record.cellCount; i++) {
+        writeCell(undoCells.back().first, undoCells.back().second);
+        undoCells.pop_back();
+    }
+    pc = record.pc;
+    robotCell = record.robotCell;
+    robotDirection = record.robotDirection;
+    cheeseCell = record.cheeseCell;
+    state = record.state;
+    currentBlock = record.currentBlock;
+    tickCount--;
+    undoLog.pop_back();
+}
+
+void SimulationCore::saveHistory() {
+    while ((int)undoLog.size() > UNDO_LOG_LIMIT) {
+        for (int i = 0; i < undoLog.front().cellCount; i++) {
+            undoCells.pop_front();
+        }
+        undoLog.pop_front();
+    }
+
+    if (tickCount % checkpointInterval != 0 ||
+            checkpoints.back().tick >= tickCount)
+        return;
+    checkpoints.push_back(makeCheckpoint());
+    if ((int)checkpoints.size() <= MAX_CHECKPOINTS)
+        return;
+    // Keep memory flat on long runs by keeping half as many checkpoints.
+    checkpointInterval *= 2;
+    std::vector<Checkpoint> kept{checkpoints.front()};
+    for (unsigned long long i = 1; i < checkpoints.size(); i++) {
+        if (checkpoints[i].tick % checkpointInterval == 0) {
+            kept.push_back(checkpoints[i]);
+        }
+    }
+    checkpoints.swap(kept);
+}
+
+SimulationCore::Checkpoint SimulationCore::makeCheckpoint() const {
+    return Checkpoint{tickCount, grid, pc, robotCell, robotDirection,
+                      cheeseCell, state, currentBlock, blockHash};
+}
+
+void SimulationCore::setTrace(TraceWriter *writer) {
+    trace = writer;
+    if (trace)
+        trace->begin(*this);
+}
+
+void SimulationCore::setProfile(BlockProfile *newProfile) {
+    profile = newProfile;
+}
+
+void SimulationCore::setCycleDetection(bool enabled) {
+    detectCycles = enabled;
+    origin.reset();
+    knownUntil = -1;
+    repeatTick = -1;
+    if (!enabled) {
+        seenStates.clear();
+    } else {
+        seenStates.emplace(getStateHash(), tickCount);
+    }
+}
+
+direction SimulationCore::getRobotDirection() const { return robotDirection; }
+
+enum gameState SimulationCore::getGameState() const { return state; }
@@ -0,0 +1,509 @@
+/**
+ * @file simulationcore.h
+ * @brief Header file for simulationcore.cpp, the Qt-free interpreter.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SIMULATIONCORE_H
+#define SIMULATIONCORE_H
+
+#include "bytecode.h"
+#include "constants.h"
+#include "obstacleindex.h"
+#include "tilegrid.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class BlockProfile;
+class TraceWriter;
+
+/// A tile coordinate on the map.
+struct Point {
+    int x;
+    int y;
+
+    bool operator==(const Point &other) const {
+        return x == other.x && y == other.y;
+    }
+    bool operator!=(const Point &other) const { return !(*this == other); }
+};
+
+/// A map tile that changed during the last step.
+struct TileChange {
+    int x;
+    int y;
+    MapTile tile;
+};
+
+/// Version of the rules programs run by. Bump it whenever a program could end
+/// differently or after a different number of steps, so results stored by
+/// ResultCache are dropped.
+inline constexpr std::uint32_t SEMANTICS_VERSION = 1;
+
+/// Outcome of running a program to completion.
+struct RunResult {
+    gameState state;
+    // Steps executed in total, including any taken before the call.
+    int steps;
+};
+
+/// Runs a compiled program against a map. Has no dependency on Qt so it can
+/// be linked into headless tools; Simulation wraps it for the game window.
+class SimulationCore {
+private:
+    gameState state;
+    TileGrid grid;
+    // Cell index of the cheese, -1 once eaten.
+    int cheeseCell;
+
+    // Cell index of the robot, -1 once lost.
+    int robotCell;
+    direction robotDirection;
+
+    std::vector<Instruction> code;
+    // Superinstruction form of code used by runUntilDone.
+    std::vector<Instruction> fused;
+    // Index into fused of the instruction starting at each index of code, -1
+    // inside a fused run.
+    std::vector<int> fusedIndex;
+    // Moves per iteration of the "while not ..." loop headed at each index
+    // of code whose body only moves forward, 0 elsewhere.
+    std::vector<int> straightMoves;
+    // Distances to the next solid cell, for skipping straight loops.
+    ObstacleIndex obstacles;
+    int programSize;
+    int tickCount;
+    // Index into code of the next instruction to execute.
+    int pc;
+    // Source block of the last executed instruction.
+    int currentBlock;
+    // Tiles changed by the last step.
+    std::vector<TileChange> changes;
+
+    // Whether repeated states end the run as nonTerminating.
+    bool detectCycles;
+    // XOR of blockKey over every cell holding a block, kept up to date as
+    // blocks move.
+    std::uint64_t blockHash;
+    // Hashes of the states reached before origin, with the tick each was
+    // first reached on. Steps only add to it until the first fused
+    // instruction, so it stays small however long the run.
+    std::unordered_map<std::uint64_t, int> seenStates;
+    // Last tick looked ahead to, -1 if none. No state repeats before it
+    // except at repeatTick, which is -1 if none does.
+    int knownUntil;
+    int repeatTick;
+    // Where looking ahead started, with the states reached before it, so
+    // steps past knownUntil can look further. nullptr until then.
+    std::shared_ptr<const SimulationCore> origin;
+
+    // Receives every step when recording, not owned.
+    TraceWriter *trace;
+    // Counts every executed block when profiling, not owned.
+    BlockProfile *profile;
+
+    /// Robot and program counter at the start of a stretch of code, on a
+    /// given map. The block hash stands for the map, which only changes when
+    /// a block moves.
+    struct TransitionKey {
+        int pc;
+        int robotCell;
+        direction robotDirection;
+        std::uint64_t mapHash;
+
+        bool operator==(const TransitionKey &other) const {
+            return pc == other.pc && robotCell == other.robotCell &&
+                   robotDirection == other.robotDirection &&
+                   mapHash == other.mapHash;
+        }
+    };
+
+    struct TransitionKeyHash {
+        std::size_t operator()(const TransitionKey &key) const;
+    };
+
+    /// Where a stretch of code running up to the next end while jump leaves
+    /// the robot, when it moved no block.
+    struct Transition {
+        int pc;
+        int robotCell;
+        direction robotDirection;
+        int ticks;
+        int currentBlock;
+    };
+
+    typedef std::unordered_map<TransitionKey, Transition, TransitionKeyHash>
+            TransitionTable;
+    // Filled lazily by runSegment. Shared by copies of the simulation, so
+    // replays of a run are mostly table hits.
+    std::shared_ptr<TransitionTable> transitions;
+    // Indexed by pc, set where a stretch ran too few instructions for a table
+    // lookup to pay off.
+    std::vector<bool> shortSegment;
+
+    /// What a step overwrote, so stepBack can restore it.
+    struct UndoRecord {
+        int pc;
+        int robotCell;
+        direction robotDirection;
+        int cheeseCell;
+        gameState state;
+        int currentBlock;
+        // Whether the step added its state to seenStates.
+        bool addedState;
+        // Entries the step pushed onto undoCells.
+        int cellCount;
+    };
+
+    /// Full copy of the run at one tick, for seeking past the undo log.
+    struct Checkpoint {
+        int tick;
+        TileGrid grid;
+        int pc;
+        int robotCell;
+        direction robotDirection;
+        int cheeseCell;
+        gameState state;
+        int currentBlock;
+        std::uint64_t blockHash;
+    };
+
+    // Whether steps are logged so they can be undone.
+    bool recordHistory;
+    // The most recent steps, newest at the back.
+    std::deque<UndoRecord> undoLog;
+    // Cell index and previous class bits of every tile written by a step in
+    // undoLog.
+    std::deque<std::pair<int, unsigned char>> undoCells;
+    // Checkpoints in tick order, the first one is where recording started.
+    std::vector<Checkpoint> checkpoints;
+    // Ticks between checkpoints, doubled whenever there are too many.
+    int checkpointInterval;
+
+public:
+    /**
+   * @brief SimulationCore Constructs a new simulation.
+   * @param newMap
+   * @param newProgram
+   */
+    SimulationCore(LevelView newMap, std::vector<ProgramBlock> newProgram);
+
+    /**
+   * @brief SimulationCore Constructs a simulation that continues from a board
+   * reached by another run, used to execute programs piece by piece.
+   * @param board
+   * @param newRobotCell
+   * @param newDirection
+   * @param newCheeseCell
+   * @param newProgram
+   */
+    SimulationCore(const TileGrid &board, int newRobotCell,
+                   direction newDirection, int newCheeseCell,
+                   std::vector<ProgramBlock> newProgram);
+
+    /**
+   * @brief step Execute next block.
+   */
+    void step();
+
+    /**
+   * @brief runUntilDone Run in a tight loop until the game ends or maxSteps
+   * steps have been executed in total. Runs of moves and turns execute as
+   * superinstructions and states are only remembered at loop heads; when a
+   * loop is found the run is replayed to stop on the same step as step()
+   * would. Stretches between loop heads that move no block are remembered by
+   * pc, robot and map, so running one again is a single table lookup.
+   * Loops that only walk forward skip to the last iteration that fits. Only
+   * the tiles changed by the final step are kept in getChanges, so views
+   * should reload the whole map. When the limit is hit, the run is looked at
+   * past it for a loop closing before the limit. What was found is kept, and
+   * later steps and calls look further from the same start when they get
+   * past it, so they end on the right tick without every state remembered.
+   * @param maxSteps
+   * @return The final state, notEnded if the step limit was hit.
+   */
+    RunResult runUntilDone(int maxSteps);
+
+    /**
+   * @brief runToFirstRepeat Run to the step at which step() would first find
+   * a repeated state, for callers that already know the run loops.
+   * @param period Steps between two visits of some state the run reaches, a
+   * multiple of the loop length.
+   * @return The final state, always nonTerminating.
+   */
+    RunResult runToFirstRepeat(int period);
+
+    /**
+   * @brief getRobotPos Get robot's position.
+   * @return
+   */
+    Point getRobotPos() const;
+
+    /**
+   * @brief getCheesePos Get cheese's position.
+   * @return
+   */
+    Point getCheesePos() const;
+
+    /**
+   * @brief getRobotDirection Get the robot's direction.
+   * @return
+   */
+    direction getRobotDirection() const;
+
+    /**
+   * @brief getGameState Get the current game state.
+   * @return
+   */
+    enum gameState getGameState() const;
+
+    /**
+   * @brief getCurrentBlock Get the source index of the last executed block.
+   * @return
+   */
+    int getCurrentBlock() const;
+
+    /**
+   * @brief getTickCount Get the number of steps executed so far.
+   * @return
+   */
+    int getTickCount() const;
+
+    /**
+   * @brief toString Render the map, robot and cheese as text, used for
+   * debugging.
+   * @return
+   */
+    std::string toString() const;
+
+    /**
+   * @brief getMap Get the current map with the cheese tile patched in.
+   * @return
+   */
+    std::vector<std::vector<MapTile>> getMap() const;
+
+    /**
+   * @brief getChanges Get the tiles changed by the last step, so a view can
+   * patch its copy of the map instead of calling getMap.
+   * @return
+   */
+    const std::vector<TileChange> &getChanges() const;
+
+    /**
+   * @brief getStateHash Get a hash of everything that decides the rest of
+   * the run: program counter, robot cell, heading and block positions.
+   * @return
+   */
+    std::uint64_t getStateHash() const;
+
+    /**
+   * @brief getBoardHash Get a hash of the robot cell, heading and block
+   * positions, ignoring the program counter.
+   * @return
+   */
+    std::uint64_t getBoardHash() const;
+
+    /**
+   * @brief atProgramEnd Whether the next step would run off the end of the
+   * program.
+   * @return
+   */
+    bool atProgramEnd() const;
+
+    const TileGrid &getGrid() const { return grid; }
+    int getRobotCell() const { return robotCell; }
+    int getCheeseCell() const { return cheeseCell; }
+
+    /**
+   * @brief setHistory Enable or disable the undo log behind stepBack and
+   * seekTick. The last few thousand steps are undone directly; older ticks
+   * are rebuilt from checkpoints whose spacing doubles as the run grows, so
+   * memory stays flat on long runs. runUntilDone steps one block at a time
+   * while enabled.
+   * @param enabled
+   */
+    void setHistory(bool enabled);
+
+    /**
+   * @brief stepBack Undo the last step. getChanges holds the restored tiles.
+   * @return false at the start of the recorded history.
+   */
+    bool stepBack();
+
+    /**
+   * @brief seekTick Move to any tick since history was enabled, backwards
+   * through the undo log and checkpoints, forwards by stepping. Views should
+   * reload the whole map afterwards.
+   * @param tick
+   * @return Whether the tick was reached, false if it is before the history
+   * or after the end of the run.
+   */
+    bool seekTick(int tick);
+
+    /**
+   * @brief setTrace Record every following step into a trace, or stop
+   * recording with nullptr. runUntilDone steps one block at a time while
+   * recording.
+   * @param writer Must outlive the recording, not owned.
+   */
+    void setTrace(TraceWriter *writer);
+
+    /**
+   * @brief setProfile Count every following step per block, or stop with
+   * nullptr. runUntilDone steps one block at a time while profiling, and
+   * steps undone later stay counted.
+   * @param newProfile Made for this program, must outlive the profiling, not
+   * owned.
+   */
+    void setProfile(BlockProfile *newProfile);
+
+    /**
+   * @brief setCycleDetection Enable or disable ending the run as
+   * nonTerminating once a state repeats. Enabled by default. Enabling it
+   * again only remembers states from the current one on.
+   * @param enabled
+   */
+    void setCycleDetection(bool enabled);
+
+private:
+    /**
+   * @brief initialize Reset the counters and hash the starting state.
+   */
+    void initialize();
+
+    /**
+   * @brief execute Execute a plain or fused instruction, advancing pc and the
+   * tick count by the number of blocks it covers.
+   * @param instruction
+   */
+    void execute(const Instruction &instruction);
+
+    /**
+   * @brief moveRobot Move one tile forward, pushing a block if there is one.
+   * @return Whether the robot moved.
+   */
+    bool moveRobot();
+
+    /**
+   * @brief findFirstRepeat Called after runUntilDone reached a loop head
+   * state twice. Replays from where the call started to the first step at
+   * which any state repeated.
+   * @param entry Copy of the simulation when runUntilDone started.
+   * @param period Steps between the two visits of the loop head state.
+   * @param before A tick at or after entry that is known not to come after
+   * the loop entry.
+   */
+    void findFirstRepeat(const SimulationCore &entry, int period, int before);
+
+    /**
+   * @brief findPeriod Called on a copy when runUntilDone hit the step limit
+   * without a loop head repeating. Runs on to the next loop head and from
+   * there until its state comes back, without remembering anything else.
+   * @param steps Steps to look for the state in, past the next loop head.
+   * @return Steps between the two visits, 0 if the run ended or the state did
+   * not come back.
+   */
+    int findPeriod(int steps);
+
+    /**
+   * @brief setOrigin Look ahead for repeated states from here on instead of
+   * remembering them, called once the run reaches a fused instruction.
+   */
+    void setOrigin();
+
+    /**
+   * @brief lookFurther Find out from origin whether and where the run repeats
+   * a state up to a tick, and update knownUntil and repeatTick.
+   * @param tick
+   */
+    void lookFurther(int tick);
+
+    /**
+   * @brief runSegment Run from a fused instruction to just after the next end
+   * while jump, in one table lookup when this stretch was run before on the
+   * same map.
+   * @param maxSteps
+   * @return Whether the jump was reached, false if the game ended or the next
+   * instruction would pass maxSteps.
+   */
+    bool runSegment(int maxSteps);
+
+    /**
+   * @brief skipStraightLoop At the head of a loop that only moves forward,
+   * run every iteration that lands on free cells with the condition still
+   * holding in one go, using the obstacle index.
+   * @param maxSteps
+   * @return Whether any iteration was run. The robot is then back at the
+   * loop head, just after the end while jump.
+   */
+    bool skipStraightLoop(int maxSteps);
+
+    /**
+   * @brief advanceTo Run without cycle detection until the given tick,
+   * through the transition table where possible.
+   * @param tick
+   */
+    void advanceTo(int tick);
+
+    /**
+   * @brief setLost Set the game state to lost.
+   */
+    void setLost();
+
+    /**
+   * @brief checkCondition Check if the conditional statement satisfied.
+   * @return
+   */
+    bool checkCondition(const Instruction &) const;
+
+    /**
+   * @brief toPoint Convert a cell index to a map coordinate, -1 gives
+   * (-1, -1).
+   * @param cell
+   * @return
+   */
+    Point toPoint(int cell) const;
+
+    /**
+   * @brief setCell Replace the class bits of a cell and record the change,
+   * in the undo log as well when history is enabled.
+   * @param cell
+   * @param bits
+   */
+    void setCell(int cell, unsigned char bits);
+
+    /**
+   * @brief writeCell Replace the class bits of a cell, keeping the block hash
+   * and getChanges up to date.
+   * @param cell
+   * @param bits
+   */
+    void writeCell(int cell, unsigned char bits);
+
+    /**
+   * @brief undoStep Revert the newest step of the undo log.
+   */
+    void undoStep();
+
+    /**
+   * @brief saveHistory Trim the undo log and take a checkpoint when one is
+   * due, after every step while history is enabled.
+   */
+    void saveHistory();
+
+    /**
+   * @brief makeCheckpoint Copy the current state.
+   * @return
+   */
+    Checkpoint makeCheckpoint() const;
+};
+
+#endif // SIMULATIONCORE_H
@@ -0,0 +1,153 @@
+/**
+ * @file simulationworker.cpp
+ * @brief Runs a simulation on its own thread ahead of the animation that
+ * shows it.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "simulationworker.h"
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+// Steps a skipped run takes between checks for a stop.
+const int SKIP_STRETCH = 1 << 16;
+} // namespace
+
+SimulationWorker::SimulationWorker(LevelView map,
+                                   const std::vector<ProgramBlock> &program,
+                                   int newMaxSteps, int newAheadLimit)
+    : core(map, program), profile(program), maxSteps(newMaxSteps),
+      aheadLimit(newAheadLimit > 0 ? newAheadLimit : 1),
+      finished(newMaxSteps <= 0), skipping(false), stopping(false) {
+    core.setProfile(&profile);
+    // The run is handed over to be stepped back and forth once paused.
+    core.setHistory(true);
+    // Start the thread last, once every member it reads is set.
+    thread = std::thread(&SimulationWorker::run, this);
+}
+
+SimulationWorker::~SimulationWorker() { halt(); }
+
+bool SimulationWorker::takeFrame(SimulationFrame &frame) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (frames.empty())
+        return false;
+    frame = std::move(frames.front());
+    frames.pop_front();
+    frameTaken.notify_one();
+    return true;
+}
+
+void SimulationWorker::skip() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (finished) {
+            // The worker is done with the core, end on its whole map now.
+            if (!frames.empty()) {
+                SimulationFrame end = frames.back();
+                end.changes.clear();
+                end.map = core.getMap();
+                frames.assign(1, end);
+            }
+            return;
+        }
+        skipping = true;
+        frames.clear();
+    }
+    frameTaken.notify_all();
+}
+
+SimulationCore SimulationWorker::stop(int tick) {
+    halt();
+    core.setProfile(nullptr);
+    // The worker runs at most aheadLimit steps ahead, well inside the undo
+    // log, so this only replays a skipped run.
+    core.seekTick(tick);
+    return std::move(core);
+}
+
+bool SimulationWorker::isDone() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return finished && frames.empty();
+}
+
+bool SimulationWorker::getProfile(BlockProfile &copy) {
+    // The worker no longer touches the profile once finished is set.
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!finished)
+        return false;
+    copy = profile;
+    return true;
+}
+
+void SimulationWorker::run() {
+    bool last = finished;
+    bool skipped = false;
+    while (!last) {
+        core.step();
+        last = core.getGameState() != notEnded ||
+                core.getTickCount() >= maxSteps;
+        SimulationFrame frame = makeFrame();
+
+        // The core is only touched by this thread, the lock guards the queue.
+        std::unique_lock<std::mutex> lock(mutex);
+        frameTaken.wait(lock, [this]() {
+            return stopping || skipping || (int)frames.size() < aheadLimit;
+        });
+        if (stopping)
+            return;
+        if (skipping) {
+            skipped = true;
+            break;
+        }
+        frames.push_back(std::move(frame));
+        // Whoever takes the last frame finds the run finished.
+        finished = last;
+    }
+    if (!skipped)
+        return;
+
+    // Finish in stretches, so a stop is noticed in between.
+    while (core.getGameState() == notEnded && core.getTickCount() < maxSteps) {
+        core.runUntilDone(std::min(maxSteps - core.getTickCount(),
+                                   SKIP_STRETCH) +
+                          core.getTickCount());
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping)
+            return;
+    }
+    SimulationFrame frame = makeFrame();
+    frame.changes.clear();
+    frame.map = core.getMap();
+    std::lock_guard<std::mutex> lock(mutex);
+    frames.clear();
+    frames.push_back(std::move(frame));
+    finished = true;
+}
+
+SimulationFrame SimulationWorker::makeFrame() const {
+    gameState state = core.getGameState();
+    return SimulationFrame{core.getTickCount(),
+                           state == lost || state == nonTerminating
+                                   ? -1
+                                   : core.getCurrentBlock(),
+                           core.getRobotPos(), core.getRobotDirection(), state,
+                           core.getChanges(), {}};
+}
+
+void SimulationWorker::halt() {
+    if (!thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frameTaken.notify_all();
+    thread.join();
+}
@@ -0,0 +1,137 @@
+/**
+ * @file simulationworker.h
+ * @brief Header file for simulationworker.cpp, runs a simulation on its own
+ * thread ahead of the animation that shows it.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SIMULATIONWORKER_H
+#define SIMULATIONWORKER_H
+
+#include "blockprofile.h"
+#include "constants.h"
+#include "simulationcore.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Everything the canvas needs to show one step.
+struct SimulationFrame {
+    int tick;
+    // Source block executed on this tick, -1 once the run is lost or loops.
+    int block;
+    // (-1, -1) once the robot is lost.
+    Point robot;
+    direction robotDirection;
+    gameState state;
+    // Tiles changed by this step.
+    std::vector<TileChange> changes;
+    // Every tile, only on the frame that ends a skipped run. changes is then
+    // empty.
+    std::vector<std::vector<MapTile>> map;
+};
+
+/// Steps a SimulationCore on a worker thread and queues a frame per step.
+/// The worker runs at most aheadLimit frames ahead of whoever takes them and
+/// then waits, so a program that never ends costs a bounded amount of memory
+/// while the player watches. The consumer never blocks: takeFrame returns
+/// false when the worker has not produced the next frame yet. Every run is
+/// profiled on the way. The run keeps its history, so it can be handed over
+/// at the frame on screen and stepped by hand from there.
+class SimulationWorker {
+private:
+    SimulationCore core;
+    BlockProfile profile;
+    int maxSteps;
+    int aheadLimit;
+    std::mutex mutex;
+    std::condition_variable frameTaken;
+    std::deque<SimulationFrame> frames;
+    // Whether the run ended or hit maxSteps, set together with queueing the
+    // last frame.
+    bool finished;
+    // Whether the rest of the run goes without frames.
+    bool skipping;
+    bool stopping;
+    std::thread thread;
+
+public:
+    /**
+   * @brief SimulationWorker Start running a program. The level is copied
+   * before the constructor returns.
+   * @param map
+   * @param program
+   * @param newMaxSteps Steps after which the worker gives up.
+   * @param newAheadLimit Frames queued at most.
+   */
+    SimulationWorker(LevelView map, const std::vector<ProgramBlock> &program,
+                     int newMaxSteps, int newAheadLimit = 1024);
+
+    /**
+   * @brief ~SimulationWorker Stop the worker and wait for it.
+   */
+    ~SimulationWorker();
+
+    SimulationWorker(const SimulationWorker &) = delete;
+    SimulationWorker &operator=(const SimulationWorker &) = delete;
+
+    /**
+   * @brief takeFrame Take the oldest queued frame.
+   * @param frame Receives the frame.
+   * @return false if no frame is ready yet or the run is over.
+   */
+    bool takeFrame(SimulationFrame &frame);
+
+    /**
+   * @brief skip Run the rest of the program at full speed on the worker
+   * thread. Frames not taken yet are dropped, and a single frame with the
+   * whole map ends the run.
+   */
+    void skip();
+
+    /**
+   * @brief stop Stop the worker and hand over its run, for stepping by hand.
+   * Only the frames queued past the given tick are undone.
+   * @param tick Tick of the last frame taken, 0 if none.
+   * @return The run at that tick, with its history.
+   */
+    SimulationCore stop(int tick);
+
+    /**
+   * @brief isDone Whether every frame has been produced and taken.
+   * @return
+   */
+    bool isDone();
+
+    /**
+   * @brief getProfile Copy the profile of the whole run. Ready as soon as the
+   * last frame can be taken.
+   * @param copy Receives the profile.
+   * @return false while the worker is still running.
+   */
+    bool getProfile(BlockProfile &copy);
+
+private:
+    /**
+   * @brief run Worker loop.
+   */
+    void run();
+
+    /**
+   * @brief makeFrame Describe the last step of the core.
+   * @return
+   */
+    SimulationFrame makeFrame() const;
+
+    /**
+   * @brief halt Tell the worker to stop and wait for it.
+   */
+    void halt();
+};
+
+#endif // SIMULATIONWORKER_H
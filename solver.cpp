@@ -0,0 +1,300 @@
+/**
+ * @file solver.cpp
+ * @brief Finds the shortest program that wins a level.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "solver.h"
+#include "distancefield.h"
+#include "simulationcore.h"
+#include "threadpool.h"
+#include "zobrist.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/// Board reached after executing every closed piece of a prefix.
+struct Board {
+    TileGrid grid;
+    int robotCell;
+    direction robotDirection;
+    int cheeseCell;
+};
+
+/// A prefix of a candidate program.
+struct Node {
+    std::vector<SolverBlock> blocks;
+    // Indices into blocks of the if / while heads still open.
+    std::vector<int> open;
+    // Board after blocks[0, boundary), the longest prefix with nothing open.
+    std::shared_ptr<const Board> board;
+    int boundary;
+    bool hasEat;
+    std::uint64_t prefixHash;
+};
+
+/// Shortest known prefix reaching a board.
+struct Seen {
+    int length;
+    std::uint64_t prefixHash;
+};
+
+const int SHARD_COUNT = 64;
+
+struct Shard {
+    std::mutex mutex;
+    std::unordered_map<std::uint64_t, Seen> boards;
+};
+
+bool isHead(ProgramBlock type) {
+    return type == ifStatement || type == whileLoop;
+}
+
+class Search {
+public:
+    Search(const std::vector<std::vector<MapTile>> &level,
+           const SolverOptions &options, WorkStealingPool &pool)
+        : options(options), pool(pool), solved(false), nodes(0),
+          length(0) {
+        ProgramBlock facings[] = {conditionFacingWall, conditionFacingBlock,
+                                  conditionFacingPit, conditionFacingCheese};
+        alphabet.push_back(SolverBlock{moveForward, blank, blank});
+        alphabet.push_back(SolverBlock{turnLeft, blank, blank});
+        alphabet.push_back(SolverBlock{turnRight, blank, blank});
+        alphabet.push_back(SolverBlock{eatCheese, blank, blank});
+        for (ProgramBlock head : {ifStatement, whileLoop}) {
+            for (ProgramBlock isNot : {blank, conditionNot}) {
+                for (ProgramBlock facing : facings) {
+                    alphabet.push_back(SolverBlock{head, isNot, facing});
+                }
+            }
+        }
+        alphabet.push_back(SolverBlock{endIf, blank, blank});
+        alphabet.push_back(SolverBlock{endWhile, blank, blank});
+
+        SimulationCore start(level, std::vector<ProgramBlock>{beginBlock});
+        auto board = std::make_shared<Board>(
+                    Board{start.getGrid(), start.getRobotCell(),
+                          start.getRobotDirection(), start.getCheeseCell()});
+        root = Node{{}, {}, board, 0, false, 0};
+        claim(start.getBoardHash(), 0, 0);
+        cheeseDistance = DistanceField(start.getGrid(), start.getCheeseCell());
+    }
+
+    /**
+   * @brief run Try every program of exactly the given length.
+   * @param newLength
+   */
+    void run(int newLength) {
+        length = newLength;
+        // Pushing blocks never opens a way to the cheese.
+        if (cheeseDistance.at(root.board->robotCell) < 0)
+            return;
+        // Hand the first few levels of the tree to the pool as separate
+        // tasks, deeper levels are searched inline by whoever owns them.
+        splitDepth = length > 3 ? 3 : length - 1;
+        pool.submit([this] { expand(root); });
+        pool.wait();
+    }
+
+    bool isSolved() const { return solved; }
+    long long getNodes() const { return nodes; }
+    const std::vector<SolverBlock> &getSolution() const { return solution; }
+
+private:
+    const SolverOptions &options;
+    WorkStealingPool &pool;
+    std::vector<SolverBlock> alphabet;
+    Node root;
+    // Fewest moves from each cell to the cheese, the same for every board.
+    DistanceField cheeseDistance;
+    Shard shards[SHARD_COUNT];
+    std::atomic<bool> solved;
+    std::atomic<long long> nodes;
+    std::mutex solutionMutex;
+    std::vector<SolverBlock> solution;
+    int length;
+    int splitDepth;
+
+    /**
+   * @brief claim Record that a prefix reaches a board.
+   * @return false if a shorter prefix, or another prefix of the same length,
+   * already reaches it.
+   */
+    bool claim(std::uint64_t boardHash, int prefixLength,
+               std::uint64_t prefixHash) {
+        Shard &shard = shards[boardHash % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.boards.find(boardHash);
+        if (found == shard.boards.end() ||
+                found->second.length > prefixLength) {
+            shard.boards[boardHash] = Seen{prefixLength, prefixHash};
+            return true;
+        }
+        return found->second.length == prefixLength &&
+                found->second.prefixHash == prefixHash;
+    }
+
+    /**
+   * @brief allowed Syntactic pruning: brackets, room left to close them and
+   * to eat, and block pairs that are never part of a shortest program.
+   */
+    bool allowed(const Node &node, const SolverBlock &block) const {
+        int remaining = length - (int)node.blocks.size() - 1;
+        int open = node.open.size();
+        bool hasEat = node.hasEat || block.type == eatCheese;
+        const SolverBlock *last =
+                node.blocks.empty() ? nullptr : &node.blocks.back();
+
+        if (block.type == endIf || block.type == endWhile) {
+            if (open == 0)
+                return false;
+            ProgramBlock head = node.blocks[node.open.back()].type;
+            if ((block.type == endIf) != (head == ifStatement))
+                return false;
+            // Empty bodies do nothing.
+            if (node.open.back() == (int)node.blocks.size() - 1)
+                return false;
+            open--;
+        } else if (isHead(block.type)) {
+            open++;
+            // A head right after a head testing the same sensor is always
+            // true or always false.
+            if (last && isHead(last->type) && last->facing == block.facing)
+                return false;
+        } else if (last && (block.type == turnLeft || block.type == turnRight)) {
+            // Left then right undo each other, two lefts equal two rights,
+            // three rights equal one left.
+            if (last->type == turnLeft)
+                return false;
+            if (block.type == turnLeft && last->type == turnRight)
+                return false;
+            if (block.type == turnRight && last->type == turnRight &&
+                    node.blocks.size() >= 2 &&
+                    node.blocks[node.blocks.size() - 2].type == turnRight)
+                return false;
+        }
+
+        bool needsBody = isHead(block.type);
+        int needed = open + ((needsBody || !hasEat) ? 1 : 0);
+        return needed <= remaining;
+    }
+
+    void expand(const Node &node) {
+        for (unsigned long long index = 0; index < alphabet.size(); index++) {
+            if (solved)
+                return;
+            const SolverBlock &block = alphabet[index];
+            if (!allowed(node, block))
+                continue;
+            nodes++;
+
+            Node child = node;
+            child.blocks.push_back(block);
+            child.hasEat = node.hasEat || block.type == eatCheese;
+            child.prefixHash = mixHash(node.prefixHash ^ (index + 1));
+            if (isHead(block.type)) {
+                child.open.push_back(child.blocks.size() - 1);
+            } else if (block.type == endIf || block.type == endWhile) {
+                child.open.pop_back();
+            }
+
+            if (child.open.empty() && !advance(child))
+                continue;
+
+            if ((int)child.blocks.size() == length)
+                continue;
+            if ((int)child.blocks.size() <= splitDepth) {
+                pool.submit([this, child] { expand(child); });
+            } else {
+                expand(child);
+            }
+        }
+    }
+
+    /**
+   * @brief advance Execute the piece closed by the last block from the
+   * previous board.
+   * @return false if the prefix is pruned or wins.
+   */
+    bool advance(Node &child) {
+        const Board &board = *child.board;
+        std::vector<SolverBlock> piece(child.blocks.begin() + child.boundary,
+                                       child.blocks.end());
+        SimulationCore simulation(board.grid, board.robotCell,
+                                  board.robotDirection, board.cheeseCell,
+                                  expandBlocks(piece));
+        while (simulation.getGameState() == notEnded &&
+               !simulation.atProgramEnd() &&
+               simulation.getTickCount() < options.maxSteps) {
+            simulation.step();
+        }
+
+        if (simulation.getGameState() == won) {
+            std::lock_guard<std::mutex> lock(solutionMutex);
+            if (!solved) {
+                solution = child.blocks;
+                solved = true;
+            }
+            return false;
+        }
+        if (simulation.getGameState() != notEnded || !simulation.atProgramEnd())
+            return false;
+        // Two blocks leave no room for a loop, so every move needs its own
+        // block and the last one has to be the eat.
+        int remaining = length - (int)child.blocks.size();
+        int distance = cheeseDistance.at(simulation.getRobotCell());
+        if (distance < 0 || (remaining < 3 && distance > remaining - 1))
+            return false;
+        if (!claim(simulation.getBoardHash(), child.blocks.size(),
+                   child.prefixHash))
+            return false;
+
+        child.board = std::make_shared<Board>(
+                    Board{simulation.getGrid(), simulation.getRobotCell(),
+                          simulation.getRobotDirection(),
+                          simulation.getCheeseCell()});
+        child.boundary = child.blocks.size();
+        return true;
+    }
+};
+
+} // namespace
+
+std::vector<ProgramBlock> expandBlocks(const std::vector<SolverBlock> &blocks) {
+    std::vector<ProgramBlock> program{beginBlock};
+    for (const SolverBlock &block : blocks) {
+        program.push_back(block.type);
+        if (isHead(block.type)) {
+            program.push_back(block.isNot);
+            program.push_back(block.facing);
+        }
+    }
+    return program;
+}
+
+SolverResult solveLevel(const std::vector<std::vector<MapTile>> &level,
+                        const SolverOptions &options) {
+    WorkStealingPool pool(options.threads);
+    Search search(level, options, pool);
+    for (int length = 1; length <= options.maxBlocks; length++) {
+        search.run(length);
+        if (search.isSolved())
+            break;
+    }
+
+    SolverResult result{search.isSolved(), {}, {}, search.getNodes()};
+    if (result.solved) {
+        result.blocks = search.getSolution();
+        result.program = expandBlocks(result.blocks);
+    }
+    return result;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file solver.h
+ * @brief Header file for solver.cpp, finds the shortest program that wins a
+ * level.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "constants.h"
+#include <vector>
+
+/// One block as placed in the editor. Conditions live inside their if or
+/// while block, so they do not count towards the block count.
+struct SolverBlock {
+    ProgramBlock type;
+    // conditionNot or blank.
+    ProgramBlock isNot;
+    // One of the conditionFacing* blocks, blank for other blocks.
+    ProgramBlock facing;
+};
+
+/// Limits for a search.
+struct SolverOptions {
+    // Longest program tried, in editor blocks (Begin not counted).
+    int maxBlocks = 8;
+    // Steps allowed for each piece of a candidate program.
+    int maxSteps = 10000;
+    // Worker threads, 0 picks one per hardware thread.
+    int threads = 0;
+};
+
+/// Outcome of a search.
+struct SolverResult {
+    bool solved;
+    // Shortest winning program in editor blocks, valid when solved.
+    std::vector<SolverBlock> blocks;
+    // The same program in the form MachineGraph::getProgram produces.
+    std::vector<ProgramBlock> program;
+    // Candidate prefixes the search looked at.
+    long long nodes;
+};
+
+/**
+ * @brief solveLevel Search for the shortest program that wins the level under
+ * SimulationCore semantics. Program lengths are tried in increasing order
+ * (iterative deepening). Whenever a prefix closes all of its if and while
+ * blocks its effect no longer depends on what follows, so it is executed
+ * once and prefixes reaching a board already reached by a shorter or earlier
+ * prefix are pruned. Subtrees are spread over a work-stealing thread pool.
+ * @param level
+ * @param options
+ * @return
+ */
+SolverResult solveLevel(const std::vector<std::vector<MapTile>> &level,
+                        const SolverOptions &options);
+
+/**
+ * @brief expandBlocks Convert editor blocks into a program vector, starting
+ * with the begin block and with each if/while followed by its two condition
+ * slots.
+ * @param blocks
+ * @return
+ */
+std::vector<ProgramBlock> expandBlocks(const std::vector<SolverBlock> &blocks);
+
+#endif // SOLVER_H
@@ -0,0 +1,163 @@
+/**
+ * @file startsweep.cpp
+ * @brief Runs one program from every start cell and heading of a map.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "startsweep.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+StartSweep::StartSweep(const std::vector<std::vector<MapTile>> &map,
+                       const std::vector<ProgramBlock> &program)
+    : grid(map), cheeseCell(-1), program(program),
+      code(compileProgram(program)) {
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (map[y][x] == cheese)
+                cheeseCell = grid.index(x, y);
+        }
+    }
+}
+
+bool StartSweep::canStart(int x, int y) const {
+    return !(grid.at(grid.index(x, y)) & tileSolid);
+}
+
+RunResult StartSweep::run(int x, int y, direction dir, int maxSteps) {
+    int cell = grid.index(x, y);
+    std::uint64_t key = stateKey(0, cell, dir);
+    auto found = states.find(key);
+    StateResult result = found != states.end() ? found->second : evaluate(key);
+
+    gameState state = nonTerminating;
+    int steps = result.steps;
+    switch (result.kind) {
+    case movesBlock: {
+        // The map changes from here on, so this start runs on its own copy.
+        SimulationCore simulation(grid, cell, dir, cheeseCell, program);
+        return simulation.runUntilDone(maxSteps);
+    }
+    case endsWon:
+        state = won;
+        break;
+    case endsLost:
+        state = lost;
+        break;
+    case loops:
+        // The first repeated state is where the loop is entered, one period
+        // after reaching it.
+        steps += result.period;
+        break;
+    case visiting:
+        break;
+    }
+    if (steps > maxSteps)
+        return RunResult{notEnded, maxSteps};
+    return RunResult{state, steps};
+}
+
+StartSweep::StateResult StartSweep::evaluate(std::uint64_t key) {
+    std::uint64_t first = key;
+    int cells = grid.getStride() * (grid.getHeight() + 2);
+    int pc = key / 4 / cells;
+    int cell = key / 4 % cells;
+    direction dir = (direction)(key % 4);
+    walk.clear();
+
+    while (true) {
+        auto found = states.find(key);
+        if (found != states.end() && found->second.kind == visiting) {
+            // Back on a state of this walk, everything since is the loop.
+            int entry = found->second.steps;
+            int period = walk.size() - entry;
+            for (unsigned long long i = entry; i < walk.size(); i++) {
+                states[walk[i]] = StateResult{loops, 0, period};
+            }
+            walk.resize(entry);
+            settle(StateResult{loops, 0, period});
+            break;
+        }
+        if (found != states.end()) {
+            settle(found->second);
+            break;
+        }
+        states[key] = StateResult{visiting, (int)walk.size(), 0};
+        walk.push_back(key);
+
+        // One step of SimulationCore::execute on the untouched map.
+        StateKind end = visiting;
+        if (pc == (int)code.size()) {
+            end = endsLost;
+        } else {
+            const Instruction &instruction = code[pc++];
+            int ahead = cell + grid.offset(dir);
+            unsigned char facing = grid.at(ahead);
+            switch (instruction.op) {
+            case opMove: {
+                unsigned char behind = facing & tileBlock
+                        ? grid.at(ahead + grid.offset(dir))
+                        : 0;
+                switch (moveOutcome(facing, behind)) {
+                case moveWalks:
+                    cell = ahead;
+                    break;
+                case moveFalls:
+                    end = endsLost;
+                    break;
+                case movePushes:
+                case moveDropsBlock:
+                    end = movesBlock;
+                    break;
+                case moveBlocked:
+                    break;
+                }
+                break;
+            }
+            case opTurnLeft:
+                dir = rotate(dir, 3);
+                break;
+            case opTurnRight:
+                dir = rotate(dir, 1);
+                break;
+            case opEat:
+                if (cell == cheeseCell)
+                    end = endsWon;
+                break;
+            case opBranch:
+                if (!conditionHolds(facing, instruction.mask,
+                                    instruction.negate))
+                    pc = instruction.target;
+                break;
+            case opJump:
+                pc = instruction.target;
+                break;
+            default:
+                break;
+            }
+        }
+        if (end != visiting) {
+            settle(StateResult{end, 0, 0});
+            break;
+        }
+        key = stateKey(pc, cell, dir);
+    }
+    return states[first];
+}
+
+void StartSweep::settle(StateResult next) {
+    for (int i = walk.size() - 1; i >= 0; i--) {
+        next.steps++;
+        states[walk[i]] = next;
+    }
+    walk.clear();
+}
+
+std::uint64_t StartSweep::stateKey(int pc, int cell, direction dir) const {
+    std::uint64_t cells = grid.getStride() * (grid.getHeight() + 2);
+    return ((std::uint64_t)pc * cells + cell) * 4 + dir;
+}
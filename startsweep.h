@@ -0,0 +1,112 @@
+/**
+ * @file startsweep.h
+ * @brief Header file for startsweep.cpp, runs one program from every start
+ * cell and heading of a map.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef STARTSWEEP_H
+#define STARTSWEEP_H
+
+#include "bytecode.h"
+#include "constants.h"
+#include "simulationcore.h"
+#include "tilegrid.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// Outcomes of one program for every cell the robot could start on, facing
+/// each way. Until the robot moves a block the map is the one it started on,
+/// so the whole run state is the pc, robot cell and heading. Those states are
+/// evaluated once and shared by every start whose run passes through them:
+/// each keeps how many steps are left until the run wins or loses, or how
+/// far it is from a loop it never leaves. Only runs that move a block are
+/// simulated on their own.
+class StartSweep {
+private:
+    TileGrid grid;
+    // Cell index of the cheese, -1 if the map has none.
+    int cheeseCell;
+    std::vector<ProgramBlock> program;
+    std::vector<Instruction> code;
+
+    enum StateKind { visiting, endsWon, endsLost, loops, movesBlock };
+
+    /// What happens after a state of the untouched map.
+    struct StateResult {
+        StateKind kind;
+        // Steps until the run ends, or until it first reaches its loop. While
+        // visiting, the position of the state on the current walk.
+        int steps;
+        // Steps around the loop.
+        int period;
+    };
+    std::unordered_map<std::uint64_t, StateResult> states;
+    // States of the walk in progress, oldest first.
+    std::vector<std::uint64_t> walk;
+
+public:
+    /**
+   * @brief StartSweep Prepare to run a program from any start on a level.
+   * @param map
+   * @param program
+   */
+    StartSweep(const std::vector<std::vector<MapTile>> &map,
+               const std::vector<ProgramBlock> &program);
+
+    int getWidth() const { return grid.getWidth(); }
+    int getHeight() const { return grid.getHeight(); }
+
+    /**
+   * @brief canStart See whether the robot can start on a map cell, any cell
+   * it could walk on.
+   * @param x
+   * @param y
+   * @return
+   */
+    bool canStart(int x, int y) const;
+
+    /**
+   * @brief run Get the outcome of the program from one start, the same as
+   * SimulationCore::runUntilDone would give.
+   * @param x
+   * @param y
+   * @param dir
+   * @param maxSteps
+   * @return
+   */
+    RunResult run(int x, int y, direction dir, int maxSteps);
+
+    /**
+   * @brief getStateCount Get the number of distinct states evaluated so far
+   * over all starts.
+   * @return
+   */
+    int getStateCount() const { return states.size(); }
+
+private:
+    /**
+   * @brief evaluate Walk from a state until the run ends, loops, moves a
+   * block or reaches a state evaluated before, then settle every state
+   * walked through.
+   * @param key
+   * @return The result of the state.
+   */
+    StateResult evaluate(std::uint64_t key);
+
+    /**
+   * @brief settle Give every state of the walk its result, counting back
+   * from what follows the last one.
+   * @param next The result of the state after the last one, or of the end
+   * of the run with no steps left.
+   */
+    void settle(StateResult next);
+
+    std::uint64_t stateKey(int pc, int cell, direction dir) const;
+};
+
+#endif // STARTSWEEP_H
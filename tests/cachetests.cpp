@@ -0,0 +1,147 @@
+/**
+ * @file cachetests.cpp
+ * @brief Tests of the result cache and its file.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "resultcache.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int HEADER_SIZE = 12;
+const int RECORD_SIZE = 24;
+
+/**
+ * @brief makeKey Key of a program of number + 1 moves.
+ * @param number
+ * @return
+ */
+ResultKey makeKey(int number) {
+    std::string program;
+    for (int i = 0; i <= number; i++) {
+        program += "move ";
+    }
+    return resultKey(textLevel(">**C"), textProgram(program));
+}
+
+bool knows(ResultCache &cache, const ResultKey &key, int maxSteps,
+           gameState state, int steps) {
+    RunResult result{notEnded, -1};
+    return cache.lookup(key, maxSteps, result) && result.state == state &&
+            result.steps == steps;
+}
+
+} // namespace
+
+void testResultCache() {
+    std::string path = temporaryPath("results.cache");
+    std::string error;
+    ResultKey first = resultKey(textLevel(">**C"), textProgram("move move eat"));
+    ResultKey second = resultKey(textLevel(">**C"), textProgram("move eat"));
+    check(!(first == second), "different programs share a key");
+    // Keys come from the compiled program, not from how it was written.
+    check(resultKey(textLevel(">**C"), textProgram("move  move eat")) == first,
+          "the same program gets another key");
+
+    {
+        ResultCache cache;
+        check(cache.open(path, error), "cannot open a new file: " + error);
+        cache.store(first, 50, RunResult{won, 3});
+        cache.store(second, 50, RunResult{notEnded, 50});
+        // Each result is on disk as soon as it is stored.
+        check(fileSize(path) == HEADER_SIZE + 2 * RECORD_SIZE,
+              "stored results are not written out");
+        check(knows(cache, first, 50, won, 3), "a win is not remembered");
+        check(knows(cache, first, 2, notEnded, 2),
+              "a win does not answer a smaller limit");
+        check(knows(cache, second, 40, notEnded, 40),
+              "an unfinished run does not answer a smaller limit");
+        RunResult result{notEnded, 0};
+        check(!cache.lookup(second, 60, result),
+              "an unfinished run answers a larger limit");
+    }
+
+    {
+        // A run that went on longer replaces the shorter one.
+        ResultCache cache;
+        check(cache.open(path, error), "cannot reopen: " + error);
+        check(knows(cache, first, 50, won, 3), "a win is not reloaded");
+        cache.store(second, 100, RunResult{lost, 70});
+        check(knows(cache, second, 100, lost, 70), "a loss is not stored");
+    }
+
+    {
+        ResultCache cache;
+        check(cache.open(path, error), "cannot reopen: " + error);
+        check(knows(cache, second, 100, lost, 70),
+              "the later result does not win on reload");
+    }
+
+    // A result cut short by a crash is dropped, the rest is kept.
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x01\x02\x03\x04\x05", 5);
+    }
+    {
+        ResultCache cache;
+        check(cache.open(path, error), "cannot open a cut file: " + error);
+        check((fileSize(path) - HEADER_SIZE) % RECORD_SIZE == 0,
+              "a cut record is not dropped");
+        check(knows(cache, first, 50, won, 3) &&
+                      knows(cache, second, 100, lost, 70),
+              "results before a cut record are lost");
+    }
+
+    // Compacting drops superseded records, not results past the memory limit.
+    path = temporaryPath("compact.cache");
+    const int KEYS = 6;
+    {
+        ResultCache cache(2);
+        check(cache.open(path, error), "cannot open a new file: " + error);
+        for (int i = 0; i < KEYS; i++) {
+            cache.store(makeKey(i), 1000, RunResult{won, i + 1});
+        }
+        for (int steps = 1; steps <= 20; steps++) {
+            cache.store(makeKey(KEYS), steps, RunResult{notEnded, steps});
+        }
+        check(cache.getSize() == 2, "the memory limit is not kept");
+    }
+    {
+        ResultCache cache(2);
+        check(cache.open(path, error), "cannot compact: " + error);
+    }
+    check(fileSize(path) == HEADER_SIZE + (KEYS + 1) * RECORD_SIZE,
+          "compacting does not keep exactly one result per key");
+    {
+        ResultCache cache;
+        check(cache.open(path, error), "cannot reopen: " + error);
+        for (int i = 0; i < KEYS; i++) {
+            check(knows(cache, makeKey(i), 1000, won, i + 1),
+                  "compacting lost result " + std::to_string(i));
+        }
+        check(knows(cache, makeKey(KEYS), 20, notEnded, 20),
+              "compacting did not keep the longest unfinished run");
+    }
+
+    // A file written under other rules is started over.
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in |
+                                        std::ios::out);
+        file.seekp(8);
+        file.write("\xff\xff\xff\xff", 4);
+    }
+    {
+        ResultCache cache;
+        check(cache.open(path, error), "cannot replace an old file: " + error);
+        check(cache.getSize() == 0 && fileSize(path) == HEADER_SIZE,
+              "results of other rules are kept");
+    }
+}
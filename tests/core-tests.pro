@@ -0,0 +1,28 @@
+TEMPLATE = app
+TARGET = core-tests
+
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle qt
+
+include(../core.pri)
+
+INCLUDEPATH += ../server
+
+SOURCES += \
+    cachetests.cpp \
+    enginetests.cpp \
+    generatortests.cpp \
+    historytests.cpp \
+    main.cpp \
+    packtests.cpp \
+    profiletests.cpp \
+    ruletests.cpp \
+    servertests.cpp \
+    solvertests.cpp \
+    tracetests.cpp \
+    verifiertests.cpp \
+    ../server/gradingserver.cpp
+
+HEADERS += \
+    testing.h \
+    ../server/gradingserver.h
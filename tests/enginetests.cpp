@@ -0,0 +1,278 @@
+/**
+ * @file enginetests.cpp
+ * @brief Runs random programs on random levels through every engine and
+ * checks each against SimulationCore stepped one block at a time.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "batchsimulation.h"
+#include "constants.h"
+#include "multisimulation.h"
+#include "simulationcore.h"
+#include "startsweep.h"
+#include "tilegrid.h"
+#include "worldsimulation.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Mismatches name the round that found them, so a failing round can be run
+// again on its own seed.
+namespace {
+
+const int MAX_SIZE = 10;
+const int MAX_PROGRAM_LENGTH = 25;
+
+/// Random levels and programs.
+class Tester {
+private:
+    std::mt19937 random;
+    int round;
+
+public:
+    explicit Tester(unsigned seed) : random(seed), round(0) {}
+
+    int pick(int count) { return random() % count; }
+
+    void setRound(int newRound) { round = newRound; }
+
+    void check(bool same, const std::string &what) {
+        ::check(same, "round " + std::to_string(round) + ": " + what);
+    }
+
+    /**
+   * @brief makeLevel Scatter walls, blocks and pits over the ground, then
+   * put down one cheese and one start tile.
+   * @return
+   */
+    Level makeLevel() {
+        const MapTile tiles[] = {ground, ground, ground, ground, wall, block, pit};
+        int width = 1 + pick(MAX_SIZE);
+        int height = 1 + pick(MAX_SIZE);
+        Level level(height, std::vector<MapTile>(width));
+        for (std::vector<MapTile> &row : level) {
+            for (MapTile &tile : row) {
+                tile = tiles[pick(7)];
+            }
+        }
+        level[pick(height)][pick(width)] = cheese;
+        level[pick(height)][pick(width)] = start;
+        return level;
+    }
+
+    /**
+   * @brief makeProgram Write a program with balanced ifs and whiles.
+   * @return
+   */
+    std::vector<ProgramBlock> makeProgram() {
+        const ProgramBlock conditions[] = {conditionFacingBlock,
+                                           conditionFacingWall,
+                                           conditionFacingPit,
+                                           conditionFacingCheese};
+        std::vector<ProgramBlock> program{beginBlock};
+        std::vector<ProgramBlock> open;
+        int length = 1 + pick(MAX_PROGRAM_LENGTH);
+        for (int i = 0; i < length; i++) {
+            int kind = pick(12);
+            if (kind < 5) {
+                program.push_back(moveForward);
+            } else if (kind == 5) {
+                program.push_back(turnLeft);
+            } else if (kind == 6) {
+                program.push_back(turnRight);
+            } else if (kind == 7) {
+                program.push_back(eatCheese);
+            } else if (kind < 10) {
+                ProgramBlock head = kind == 8 ? ifStatement : whileLoop;
+                program.push_back(head);
+                program.push_back(pick(2) ? conditionNot : blank);
+                program.push_back(conditions[pick(4)]);
+                open.push_back(head);
+            } else if (!open.empty()) {
+                program.push_back(open.back() == ifStatement ? endIf : endWhile);
+                open.pop_back();
+            }
+        }
+        while (!open.empty()) {
+            program.push_back(open.back() == ifStatement ? endIf : endWhile);
+            open.pop_back();
+        }
+        return program;
+    }
+
+    /**
+   * @brief makeLimit Mostly short limits that cut runs off, sometimes one
+   * long enough for any of these levels.
+   * @return
+   */
+    int makeLimit() { return pick(2) ? 1 + pick(200) : 100000; }
+};
+
+bool sameResult(const RunResult &result, const SimulationCore &reference) {
+    return result.state == reference.getGameState() &&
+            result.steps == reference.getTickCount();
+}
+
+/**
+ * @brief stepToLimit Step a reference run the slow way.
+ * @param simulation
+ * @param maxSteps
+ */
+void stepToLimit(SimulationCore &simulation, int maxSteps) {
+    while (simulation.getGameState() == notEnded &&
+           simulation.getTickCount() < maxSteps) {
+        simulation.step();
+    }
+}
+
+void checkRunUntilDone(Tester &tester, const Level &level,
+                       const std::vector<ProgramBlock> &program, int maxSteps) {
+    SimulationCore reference(level, program);
+    stepToLimit(reference, maxSteps);
+    SimulationCore fast(level, program);
+    // Start part way in now and then, the fast path picks up any step.
+    int before = tester.pick(3) == 0 ? tester.pick(std::min(maxSteps, 20)) : 0;
+    for (int i = 0; i < before && fast.getGameState() == notEnded; i++) {
+        fast.step();
+    }
+    RunResult result = fast.runUntilDone(maxSteps);
+    tester.check(sameResult(result, reference) &&
+                         fast.getRobotPos() == reference.getRobotPos() &&
+                         fast.getRobotDirection() ==
+                                 reference.getRobotDirection() &&
+                         fast.getCurrentBlock() == reference.getCurrentBlock() &&
+                         fast.getMap() == reference.getMap() &&
+                         fast.getStateHash() == reference.getStateHash(),
+                 "SimulationCore::runUntilDone differs from step");
+}
+
+void checkBatch(Tester &tester, const Level &level, int maxSteps) {
+    std::vector<std::vector<ProgramBlock>> programs;
+    int count = 1 + tester.pick(8);
+    for (int i = 0; i < count; i++) {
+        programs.push_back(tester.makeProgram());
+    }
+    // The same program twice must not share more than the level.
+    programs.push_back(programs.front());
+    BatchSimulation batch(level, programs);
+    std::vector<RunResult> results = batch.run(maxSteps);
+    for (std::size_t i = 0; i < programs.size(); i++) {
+        SimulationCore reference(level, programs[i]);
+        stepToLimit(reference, maxSteps);
+        tester.check(sameResult(results[i], reference),
+                     "BatchSimulation differs on program " + std::to_string(i));
+    }
+}
+
+void checkSweep(Tester &tester, const Level &level,
+                const std::vector<ProgramBlock> &program, int maxSteps) {
+    // The sweep places the robot itself.
+    Level map = level;
+    for (std::vector<MapTile> &row : map) {
+        for (MapTile &tile : row) {
+            if (tile == start)
+                tile = ground;
+        }
+    }
+    StartSweep sweep(map, program);
+    TileGrid grid(map);
+    int cheeseCell = -1;
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (map[y][x] == cheese)
+                cheeseCell = grid.index(x, y);
+        }
+    }
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (!sweep.canStart(x, y))
+                continue;
+            for (int dir = north; dir <= west; dir++) {
+                RunResult result = sweep.run(x, y, (direction)dir, maxSteps);
+                SimulationCore reference(grid, grid.index(x, y), (direction)dir,
+                                         cheeseCell, program);
+                stepToLimit(reference, maxSteps);
+                tester.check(sameResult(result, reference),
+                             "StartSweep differs from (" + std::to_string(x) +
+                                     ", " + std::to_string(y) + ")");
+            }
+        }
+    }
+}
+
+void checkMulti(Tester &tester, const Level &level,
+                const std::vector<ProgramBlock> &program, int maxSteps) {
+    SimulationCore reference(level, program);
+    MultiSimulation multi(level, {program});
+    while (reference.getGameState() == notEnded &&
+           reference.getTickCount() < maxSteps) {
+        reference.step();
+        multi.step();
+        if (multi.getGameState() != reference.getGameState() ||
+                multi.getMap() != reference.getMap() ||
+                (reference.getGameState() == notEnded &&
+                 multi.getRobotPos(0) != reference.getRobotPos())) {
+            tester.check(false, "MultiSimulation differs on tick " +
+                                 std::to_string(reference.getTickCount()));
+            return;
+        }
+    }
+    MultiSimulation fast(level, {program});
+    tester.check(sameResult(fast.runUntilDone(maxSteps), reference),
+                 "MultiSimulation::runUntilDone differs from step");
+}
+
+void checkWorld(Tester &tester, const Level &level,
+                const std::vector<ProgramBlock> &program, int maxSteps) {
+    SimulationCore reference(level, program);
+    WorldSimulation world(level, program);
+    while (reference.getGameState() == notEnded &&
+           reference.getTickCount() < maxSteps) {
+        reference.step();
+        world.step();
+        if (world.getGameState() != reference.getGameState() ||
+                world.getTickCount() != reference.getTickCount() ||
+                world.getRobotPos() != reference.getRobotPos() ||
+                world.getRobotDirection() != reference.getRobotDirection() ||
+                world.getCurrentBlock() != reference.getCurrentBlock()) {
+            tester.check(false, "WorldSimulation differs on tick " +
+                                 std::to_string(reference.getTickCount()));
+            return;
+        }
+    }
+    Level map = reference.getMap();
+    bool sameMap = true;
+    for (int y = 0; y < (int)map.size(); y++) {
+        for (int x = 0; x < (int)map[y].size(); x++) {
+            sameMap = sameMap &&
+                    tileFromBits(world.getWorld().at(x, y)) == map[y][x];
+        }
+    }
+    tester.check(sameMap, "WorldSimulation leaves a different map");
+    WorldSimulation fast(level, program);
+    tester.check(sameResult(fast.runUntilDone(maxSteps), reference),
+                 "WorldSimulation::runUntilDone differs from step");
+}
+
+} // namespace
+
+void testEngines(int rounds, unsigned seed) {
+    Tester tester(seed);
+    for (int round = 0; round < rounds; round++) {
+        tester.setRound(round);
+        Level level = tester.makeLevel();
+        std::vector<ProgramBlock> program = tester.makeProgram();
+        int maxSteps = tester.makeLimit();
+        checkRunUntilDone(tester, level, program, maxSteps);
+        checkBatch(tester, level, maxSteps);
+        checkSweep(tester, level, program, maxSteps);
+        checkMulti(tester, level, program, maxSteps);
+        checkWorld(tester, level, program, maxSteps);
+    }
+}
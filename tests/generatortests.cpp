@@ -0,0 +1,102 @@
+/**
+ * @file generatortests.cpp
+ * @brief Tests of the level generator and its solvability check.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "levelgenerator.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const int MAX_STATES = 100000;
+const int CANDIDATES = 200;
+const int LEVELS = 12;
+
+int countTiles(const Level &level, MapTile tile) {
+    int count = 0;
+    for (const std::vector<MapTile> &row : level) {
+        for (MapTile cell : row) {
+            count += cell == tile;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief checkPushes Check a level against the pushes it needs by hand.
+ * @param name
+ * @param level
+ * @param pushes -1 if the cheese cannot be reached.
+ */
+void checkPushes(const std::string &name, const std::string &level,
+                 int pushes) {
+    LevelCheck result = checkLevel(textLevel(level), MAX_STATES);
+    check(!result.exhausted && result.solvable == (pushes >= 0) &&
+                  (pushes < 0 || result.pushes == pushes),
+          name + ": checked as " +
+                  (result.solvable ? std::to_string(result.pushes) + " pushes"
+                                   : std::string("unsolvable")));
+}
+
+} // namespace
+
+void testGenerator() {
+    checkPushes("open", ">*C", 0);
+    checkPushes("wall", ">#C", -1);
+    checkPushes("pit", ">0C", -1);
+    // A block pushed into a pit is gone, the pit stays.
+    checkPushes("block into a pit", "#>@0#\n##*C#", 1);
+    checkPushes("block on a pit", ">@0C", -1);
+    checkPushes("block in the way", "#####\n#>@*#\n#*#C#\n#####", -1);
+    checkPushes("push and go around",
+                "######\n#>@**#\n##*#C#\n##***#\n######", 1);
+    checkPushes("stuck block", ">@#\n*#C", -1);
+
+    // Candidates come from their seed alone and are built to be winnable.
+    for (int difficulty : {1, 5, 10}) {
+        for (int seed = 0; seed < CANDIDATES; seed++) {
+            Level level = generateCandidate(difficulty, seed);
+            std::string name = "difficulty " + std::to_string(difficulty) +
+                    " seed " + std::to_string(seed);
+            if (level != generateCandidate(difficulty, seed) ||
+                    countTiles(level, start) != 1 ||
+                    countTiles(level, cheese) != 1 ||
+                    !checkLevel(level, MAX_STATES).solvable) {
+                check(false, name + " is not a winnable level");
+                break;
+            }
+        }
+    }
+
+    // The levels kept do not depend on the thread count.
+    GeneratorOptions options;
+    options.difficulty = 4;
+    options.count = LEVELS;
+    options.seed = 7;
+    options.threads = 1;
+    GeneratorResult single = generateLevels(options);
+    options.threads = 4;
+    GeneratorResult parallel = generateLevels(options);
+    check((int)single.levels.size() == LEVELS &&
+                  single.levels.size() == parallel.levels.size(),
+          "the generator does not make the levels asked for");
+    for (int i = 0; i < (int)single.levels.size() &&
+            i < (int)parallel.levels.size(); i++) {
+        const GeneratedLevel &level = single.levels[i];
+        check(level.level == parallel.levels[i].level &&
+                      level.seed == parallel.levels[i].seed,
+              "level " + std::to_string(i) + " depends on the thread count");
+        check(level.check.solvable &&
+                      level.check.pushes >= (options.difficulty + 1) / 2,
+              "level " + std::to_string(i) + " is too easy");
+        check(generateCandidate(options.difficulty, level.seed) == level.level,
+              "level " + std::to_string(i) + " is not drawn from its seed");
+    }
+}
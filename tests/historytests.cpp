@@ -0,0 +1,119 @@
+/**
+ * @file historytests.cpp
+ * @brief Tests of stepping back and seeking through a run's history.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "simulationcore.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+// Longer than the undo log, so old ticks come from checkpoints.
+const int LONG_RUN = 30000;
+const int CORRIDOR_LENGTH = 6000;
+
+/// What a view shows of one tick.
+struct Snapshot {
+    int tick;
+    int block;
+    gameState state;
+    std::string board;
+
+    bool operator==(const Snapshot &other) const {
+        return tick == other.tick && block == other.block &&
+                state == other.state && board == other.board;
+    }
+};
+
+Snapshot snapshot(const SimulationCore &simulation) {
+    return Snapshot{simulation.getTickCount(), simulation.getCurrentBlock(),
+                    simulation.getGameState(), simulation.toString()};
+}
+
+/**
+ * @brief checkUndo Step a run to its end, then step back to the start and
+ * seek around it, comparing every tick with the way forward.
+ * @param name
+ * @param level
+ * @param program
+ */
+void checkUndo(const std::string &name, const std::string &level,
+               const std::string &program) {
+    SimulationCore simulation(textLevel(level), textProgram(program));
+    simulation.setHistory(true);
+    std::vector<Snapshot> forward{snapshot(simulation)};
+    while (simulation.getGameState() == notEnded) {
+        simulation.step();
+        forward.push_back(snapshot(simulation));
+    }
+    int last = simulation.getTickCount();
+    for (int tick = last - 1; tick >= 0; tick--) {
+        check(simulation.stepBack() && snapshot(simulation) == forward[tick],
+              name + ": stepping back to tick " + std::to_string(tick) +
+                      " differs");
+    }
+    check(!simulation.stepBack(), name + ": stepped back before the start");
+    check(simulation.seekTick(last) && snapshot(simulation) == forward[last],
+          name + ": seeking to the end differs");
+    check(simulation.seekTick(last / 2) &&
+                  snapshot(simulation) == forward[last / 2],
+          name + ": seeking back to the middle differs");
+    check(!simulation.seekTick(last + 1), name + ": sought past the end");
+    check(!simulation.seekTick(-1), name + ": sought before the start");
+}
+
+} // namespace
+
+void testHistory() {
+    checkUndo("loop", "#####\n#>**#\n#*#*#\n#**C#\n#####",
+              "while not wall move if wall right endif endwhile eat");
+    // Undo has to put back the pushed block and the filled pit.
+    checkUndo("push", ">@0**C", "move move move move eat");
+    checkUndo("pit", ">*0C", "move move");
+
+    // A robot walking up and down a corridor never repeats within LONG_RUN
+    // ticks, so every tick can be told apart by robot and block.
+    std::string corridor = "#>" + std::string(CORRIDOR_LENGTH, '*') + "#";
+    SimulationCore simulation(textLevel(corridor),
+                              textProgram("while not cheese move if wall "
+                                          "right right endif endwhile"));
+    simulation.setCycleDetection(false);
+    simulation.setHistory(true);
+    std::vector<Snapshot> forward;
+    std::vector<Point> robots;
+    for (int tick = 0; tick <= LONG_RUN; tick++) {
+        if (tick > 0)
+            simulation.step();
+        forward.push_back(Snapshot{simulation.getTickCount(),
+                                   simulation.getCurrentBlock(),
+                                   simulation.getGameState(), ""});
+        robots.push_back(simulation.getRobotPos());
+    }
+    auto matches = [&](int tick) {
+        return Snapshot{simulation.getTickCount(), simulation.getCurrentBlock(),
+                        simulation.getGameState(), ""} == forward[tick] &&
+                simulation.getRobotPos() == robots[tick];
+    };
+    check(simulation.getGameState() == notEnded,
+          "the corridor run ended early");
+    // Back through the undo log and past it, one step at a time.
+    for (int tick = LONG_RUN - 1; tick >= LONG_RUN - 6000; tick--) {
+        if (!simulation.stepBack() || !matches(tick)) {
+            check(false, "corridor: stepping back to tick " +
+                                 std::to_string(tick) + " differs");
+            break;
+        }
+    }
+    for (int tick : {20000, 12345, 1, 0, 7777, LONG_RUN, 4096, LONG_RUN - 1}) {
+        check(simulation.seekTick(tick) && matches(tick),
+              "corridor: seeking to tick " + std::to_string(tick) +
+                      " differs");
+    }
+}
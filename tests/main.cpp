@@ -0,0 +1,99 @@
+/**
+ * @file main.cpp
+ * @brief Runs the tests of the Qt-free core.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "textformat.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Usage: core-tests [rounds] [seed]. Every failed check is printed with its
+// test, and the exit code is 1 if there was any. rounds and seed pick the
+// random levels of the engine comparison.
+namespace {
+
+const int DEFAULT_ROUNDS = 300;
+const int MAX_REPORTS = 10;
+
+std::string currentTest;
+int testFailures = 0;
+int failures = 0;
+
+void runTest(const std::string &name, const std::function<void()> &test) {
+    currentTest = name;
+    testFailures = 0;
+    test();
+    failures += testFailures;
+    std::cout << name << ": " << (testFailures == 0 ? "ok" : "FAILED")
+              << "\n";
+}
+
+} // namespace
+
+void check(bool passed, const std::string &what) {
+    if (passed)
+        return;
+    if (testFailures++ < MAX_REPORTS)
+        std::cerr << currentTest << ": " << what << "\n";
+}
+
+Level textLevel(const std::string &text) {
+    Level level;
+    std::string error;
+    check(parseLevel(text, level, error), "level does not parse: " + error);
+    return level;
+}
+
+std::vector<ProgramBlock> textProgram(const std::string &text) {
+    std::vector<ProgramBlock> program;
+    std::string error;
+    check(parseProgram(text, program, error),
+          "program does not parse: " + error);
+    return program;
+}
+
+std::string temporaryPath(const std::string &name) {
+    std::string path =
+            (std::filesystem::temp_directory_path() / ("core-tests-" + name))
+                    .string();
+    std::remove(path.c_str());
+    return path;
+}
+
+long long fileSize(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? (long long)file.tellg() : -1;
+}
+
+int main(int argc, char *argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : DEFAULT_ROUNDS;
+    unsigned seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+    runTest("rules", testRules);
+    runTest("engines", [rounds, seed]() { testEngines(rounds, seed); });
+    runTest("result cache", testResultCache);
+    runTest("generator", testGenerator);
+    runTest("history", testHistory);
+    runTest("level packs", testLevelPacks);
+    runTest("profile", testProfile);
+    runTest("solver", testSolver);
+    runTest("traces", testTraces);
+    runTest("verifier", testVerifier);
+    runTest("server", testServer);
+    if (failures > 0) {
+        std::cerr << failures << " checks failed, engine seed " << seed << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file packtests.cpp
+ * @brief Tests of level packs and of naming their levels.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "levelpack.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+void testLevelPacks() {
+    // An odd number of tiles leaves the last byte half used.
+    std::vector<Level> saved = {textLevel(">*C"), textLevel(">@0\n#*C"),
+                                textLevel("*\n>\nC")};
+    std::string path = temporaryPath("levels.pack");
+    check(saveLevelPack(path, saved), "cannot write a level pack");
+
+    LevelPack pack;
+    std::string error;
+    check(pack.open(path, error), "cannot open the pack: " + error);
+    check(pack.getLevelCount() == (int)saved.size(),
+          "the pack does not count its levels");
+    Level level;
+    for (int i = 0; i < (int)saved.size(); i++) {
+        check(pack.level(i, level) && level == saved[i],
+              "level " + std::to_string(i) + " does not come back");
+    }
+    check(!pack.level(-1, level) && !pack.level(3, level),
+          "a level outside the pack is decoded");
+
+    check(loadLevel(path + ":2", level, error) && level == saved[1],
+          "<pack>:2 is not the second level");
+    // 4294967297 wraps to 1 as an int.
+    for (const char *number : {"0", "4", "4294967297", "-4294967295"}) {
+        std::string name = path + ":" + number;
+        check(!loadLevel(name, level, error) && error == "no level " + name,
+              name + " is not refused");
+    }
+
+    // A damaged pack reports itself rather than being read as a text level.
+    std::string badPath = temporaryPath("bad.pack");
+    std::ofstream(badPath) << ">*C\n";
+    check(!loadLevel(badPath + ":1", level, error) &&
+                  error == badPath + " is not a level pack",
+          "a file that is not a pack is not reported: " + error);
+    check(!loadLevel(temporaryPath("missing.pack") + ":1", level, error) &&
+                  error == "cannot read " + temporaryPath("missing.pack"),
+          "a missing pack is not reported: " + error);
+    check(loadLevel(badPath, level, error) && level == textLevel(">*C"),
+          "a text level is not read: " + error);
+}
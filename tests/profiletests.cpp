@@ -0,0 +1,118 @@
+/**
+ * @file profiletests.cpp
+ * @brief Tests of the per block profile of a run.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "blockprofile.h"
+#include "simulationcore.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const int MAX_STEPS = 1000;
+
+/**
+ * @brief checkProfile Profile a run, stepped and run to its end, against the
+ * blocks it reports executing one step at a time.
+ * @param name
+ * @param level
+ * @param text
+ */
+void checkProfile(const std::string &name, const std::string &level,
+                  const std::string &text) {
+    std::vector<ProgramBlock> program = textProgram(text);
+    BlockProfile stepped(program);
+    BlockProfile fast(program);
+    std::vector<long long> executions(program.size(), 0);
+    SimulationCore simulation(textLevel(level), program);
+    simulation.setProfile(&stepped);
+    while (simulation.getGameState() == notEnded &&
+           simulation.getTickCount() < MAX_STEPS) {
+        simulation.step();
+        int block = simulation.getCurrentBlock();
+        if (block >= 0 && block < (int)program.size())
+            executions[block]++;
+    }
+    SimulationCore run(textLevel(level), program);
+    run.setProfile(&fast);
+    run.runUntilDone(MAX_STEPS);
+
+    check(stepped.getTotalSteps() == simulation.getTickCount() &&
+                  fast.getTotalSteps() == run.getTickCount(),
+          name + ": steps are not all counted");
+    const std::vector<BlockCounters> &counters = stepped.getCounters();
+    for (int i = 0; i < (int)program.size(); i++) {
+        const BlockCounters &counter = counters[i];
+        const BlockCounters &other = fast.getCounters()[i];
+        std::string block = name + ": block " + std::to_string(i);
+        check(counter.executions == executions[i],
+              block + " is counted " + std::to_string(counter.executions) +
+                      " times, ran " + std::to_string(executions[i]));
+        check(counter.executions == other.executions &&
+                      counter.conditionTrue == other.conditionTrue &&
+                      counter.steps == other.steps,
+              block + " is counted differently by runUntilDone");
+        bool head = program[i] == ifStatement || program[i] == whileLoop;
+        check(head ? counter.conditionTrue + counter.conditionFalse ==
+                             counter.executions
+                   : counter.conditionTrue + counter.conditionFalse == 0,
+              block + " has conditions counted wrong");
+        check(head ? counter.steps >= counter.executions
+                   : counter.steps == counter.executions,
+              block + " has its steps counted wrong");
+    }
+}
+
+} // namespace
+
+void testProfile() {
+    // The loop stops facing the cheese, two moves from the start.
+    std::vector<ProgramBlock> program =
+            textProgram("while not cheese move endwhile move eat");
+    BlockProfile profile(program);
+    SimulationCore simulation(textLevel(">**C"), program);
+    simulation.setProfile(&profile);
+    RunResult result = simulation.runUntilDone(MAX_STEPS);
+    const std::vector<BlockCounters> &counters = profile.getCounters();
+    check(result.state == won && profile.getTotalSteps() == result.steps,
+          "the profiled run does not win");
+    check(counters[1].executions == 3 && counters[1].conditionTrue == 2 &&
+                  counters[1].conditionFalse == 1,
+          "the while condition is not counted");
+    check(counters[4].executions == 2 && counters[6].executions == 1 &&
+                  counters[7].executions == 1,
+          "the loop body is not counted");
+    check(counters[1].steps == counters[1].executions +
+                                       counters[4].executions +
+                                       counters[5].executions,
+          "the loop does not hold the steps of its body");
+    check(counters[0].executions == 0 && counters[2].executions == 0 &&
+                  counters[3].executions == 0,
+          "the begin block or a condition slot is counted");
+
+    checkProfile("loop", "#####\n#>**#\n#*#*#\n#**C#\n#####",
+                 "while not wall move if wall right endif endwhile eat");
+    checkProfile("nested", ">*@*0C",
+                 "while not cheese if block left left endif while not wall "
+                 "move endwhile right endwhile");
+    checkProfile("ends early", ">0C", "move move eat");
+
+    // Steps stepped back over stay counted.
+    BlockProfile undone(program);
+    SimulationCore history(textLevel(">**C"), program);
+    history.setHistory(true);
+    history.setProfile(&undone);
+    for (int i = 0; i < 4; i++) {
+        history.step();
+    }
+    history.stepBack();
+    history.stepBack();
+    check(undone.getTotalSteps() == 4, "undone steps are not kept");
+}
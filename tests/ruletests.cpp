@@ -0,0 +1,123 @@
+/**
+ * @file ruletests.cpp
+ * @brief Golden runs of the game rules, each worked out by hand from the
+ * rules of the original Simulation.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "levelpack.h"
+#include "simulationcore.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief checkRun Run a program to its end, the slow way and the fast way,
+ * and compare both with the expected result.
+ * @param name
+ * @param level
+ * @param program
+ * @param state
+ * @param steps
+ * @param maxSteps
+ */
+void checkRun(const std::string &name, const std::string &level,
+              const std::string &program, gameState state, int steps,
+              int maxSteps = 1000) {
+    SimulationCore stepped(textLevel(level), textProgram(program));
+    while (stepped.getGameState() == notEnded &&
+           stepped.getTickCount() < maxSteps) {
+        stepped.step();
+    }
+    check(stepped.getGameState() == state && stepped.getTickCount() == steps,
+          name + ": stepping ends in state " +
+                  std::to_string(stepped.getGameState()) + " after " +
+                  std::to_string(stepped.getTickCount()) + " steps");
+    SimulationCore fast(textLevel(level), textProgram(program));
+    RunResult result = fast.runUntilDone(maxSteps);
+    check(result.state == state && result.steps == steps,
+          name + ": runUntilDone ends in state " +
+                  std::to_string(result.state) + " after " +
+                  std::to_string(result.steps) + " steps");
+}
+
+/**
+ * @brief checkBoard Step a program a few times and compare the board with
+ * the one expected, drawn as SimulationCore::toString draws it.
+ * @param name
+ * @param level
+ * @param program
+ * @param steps
+ * @param board
+ */
+void checkBoard(const std::string &name, const std::string &level,
+                const std::string &program, int steps,
+                const std::string &board) {
+    SimulationCore simulation(textLevel(level), textProgram(program));
+    for (int i = 0; i < steps; i++) {
+        simulation.step();
+    }
+    check(simulation.toString() == board,
+          name + ": board is " + simulation.toString() + ", expected " + board);
+}
+
+} // namespace
+
+void testRules() {
+    // The walkthrough in the README.
+    Level level;
+    std::string error;
+    check(loadLevel("4", level, error), "built-in level 4: " + error);
+    SimulationCore walkthrough(
+            level, textProgram("while not wall move if wall right endif "
+                               "endwhile eat"));
+    RunResult result = walkthrough.runUntilDone(1000);
+    check(result.state == won && result.steps == 94,
+          "level 4 walkthrough does not win after 94 steps");
+
+    // Every block takes a step, the condition slots of a head take none.
+    checkRun("eat on the cheese", ">C", "move eat", won, 2);
+    checkRun("eat off the cheese", ">C", "eat move eat", won, 3);
+    checkRun("if facing cheese", ">C", "if cheese move endif eat", won, 4);
+    // Running past the last block loses, on a step of its own.
+    checkRun("end of program", ">*", "move", lost, 2);
+    checkRun("walk into a pit", ">0", "move", lost, 1);
+
+    // End While jumps back to its own head, not to the start of the program,
+    // so the first move runs only once.
+    checkRun("end while", ">***C#", "move while not wall move endwhile eat",
+             won, 12);
+
+    // Nothing is sensed past the edge of the map, even with Not, so the loop
+    // is skipped instead of pushing against the edge forever.
+    checkRun("not past the edge", "C>", "while not wall move endwhile eat",
+             lost, 3);
+    checkBoard("if not past the edge", "*>", "if not wall left endif", 1,
+               "*>");
+    checkBoard("if not inside the map", ">*", "if not wall left endif", 2,
+               "^*");
+
+    // A pushed block moves one cell, a wall or block behind it stops it.
+    checkBoard("push a block", ">@*#", "move", 1, "*>@#");
+    checkBoard("push against a wall", ">@*#", "move move", 2, "*>@#");
+    checkBoard("push against a block", ">@@*", "move", 1, ">@@*");
+    checkBoard("push off the map", "*>@", "move", 1, "*>@");
+
+    // A block pushed into a pit is gone and the pit stays.
+    checkBoard("block into a pit", ">@0*", "move", 1, "*>0*");
+    checkRun("pit after a block", ">@0*", "move move", lost, 2);
+
+    // A state seen before means the program never ends: after four turns of
+    // three steps the robot is about to run the loop head facing east, as it
+    // started.
+    checkRun("spin forever", "###\n#>#\n###",
+             "while not cheese left endwhile", nonTerminating, 12);
+    checkRun("step limit", ">***", "while not wall move endwhile", notEnded, 2,
+             2);
+}
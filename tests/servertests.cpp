@@ -0,0 +1,139 @@
+/**
+ * @file servertests.cpp
+ * @brief Tests of the grading server's jobs and connections.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "gradingserver.h"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char *WALKTHROUGH =
+        "while not wall move if wall right endif endwhile eat";
+// How long a closed connection may take to be counted out.
+const int CLOSE_WAIT_MS = 2000;
+
+/**
+ * @brief submitJobs Send jobs over a client socket and read every result until
+ * the server closes it.
+ * @param socket
+ * @param jobs
+ * @return
+ */
+std::string submitJobs(int socket, const std::string &jobs) {
+    sendAll(socket, jobs);
+    shutdown(socket, SHUT_WR);
+    std::string results;
+    char chunk[4096];
+    ssize_t count;
+    while ((count = recv(socket, chunk, sizeof chunk, 0)) > 0) {
+        results.append(chunk, count);
+    }
+    close(socket);
+    return results;
+}
+
+bool waitForConnections(const Server &server, int count) {
+    for (int waited = 0; waited < CLOSE_WAIT_MS; waited++) {
+        if (server.connections == count)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+} // namespace
+
+void testServer() {
+    Server server(2, 0, 4, 1, 1000, nullptr);
+    check(runJob(server, std::string("a 4 0 ") + WALKTHROUGH) == "a\twon\t94\n",
+          "a built-in level is not graded");
+    check(runJob(server, std::string("b 4 10 ") + WALKTHROUGH) ==
+                  "b\tunfinished\t10\n",
+          "the job's step limit is not kept");
+    Server capped(1, 0, 1, 1, 50, nullptr);
+    check(runJob(capped, std::string("c 4 1000 ") + WALKTHROUGH) ==
+                  "c\tunfinished\t50\n",
+          "the server's step limit is not kept");
+    check(runJob(server, "d 99999 0 move") ==
+                  "d\terror\tno built-in level 99999\n",
+          "a missing built-in level is not reported");
+    check(runJob(server, "e 4") ==
+                  "e\terror\texpected <id> <level> <max-steps> <program...>\n",
+          "a short job line is not reported");
+
+    // No file a job names is read, and its content never shows in an error.
+    std::string secretPath = temporaryPath("secret.txt");
+    std::ofstream(secretPath) << "rQ>C\n";
+    std::string expected = "\terror\tunknown level " + secretPath;
+    check(runJob(server, "f " + secretPath + " 0 move")
+                          .rfind("f" + expected, 0) == 0,
+          "a level file is opened for a job");
+    check(runJob(server, "g " + secretPath + ":1 0 move")
+                          .rfind("g" + expected + ":1,", 0) == 0,
+          "a pack is opened for a job");
+
+    std::string error;
+    check(!server.levels.addPack(secretPath, error),
+          "a text file is taken for a level pack");
+    std::string packPath = temporaryPath("server.pack");
+    check(saveLevelPack(packPath, {textLevel(">C"), textLevel(">*")}),
+          "cannot write a level pack");
+    check(server.levels.addPack(packPath, error),
+          "cannot add a pack: " + error);
+    check(runJob(server, "h " + packPath + ":1 0 move eat") == "h\twon\t2\n",
+          "a pack level is not graded");
+    check(runJob(server, "i " + packPath + ":2 0 move") == "i\tlost\t2\n",
+          "the second pack level is not graded");
+    std::vector<std::string> numbers = {"0", "3", "4294967297", "-1", "1x", ""};
+    for (const std::string &number : numbers) {
+        check(runJob(server, "j " + packPath + ":" + number + " 0 move") ==
+                      "j\terror\tno level " + packPath + ":" + number + "\n",
+              "pack level " + number + " is not refused");
+    }
+
+    // One connection is allowed, the next one is turned away until it closes.
+    int first[2];
+    int second[2];
+    int third[2];
+    check(socketpair(AF_UNIX, SOCK_STREAM, 0, first) == 0 &&
+                  socketpair(AF_UNIX, SOCK_STREAM, 0, second) == 0 &&
+                  socketpair(AF_UNIX, SOCK_STREAM, 0, third) == 0,
+          "cannot make sockets");
+    check(acceptConnection(server, first[1]), "the first client is refused");
+    check(!acceptConnection(server, second[1]),
+          "the connection limit is not kept");
+    check(submitJobs(second[0], "a 1 0 move\n") ==
+                  "?\terror\ttoo many connections\n",
+          "a refused client is not told why");
+    std::string jobs;
+    for (int i = 0; i < 20; i++) {
+        jobs += std::to_string(i) + " 4 0 " + WALKTHROUGH + "\n";
+    }
+    // Results come back in the order jobs finish.
+    std::string results = "\n" + submitJobs(first[0], jobs);
+    for (int i = 0; i < 20; i++) {
+        check(results.find("\n" + std::to_string(i) + "\twon\t94\n") !=
+                      std::string::npos,
+              "job " + std::to_string(i) + " is not answered");
+    }
+    check(waitForConnections(server, 0), "a closed client is still counted");
+    check(acceptConnection(server, third[1]),
+          "a client is refused after the last one closed");
+    check(submitJobs(third[0], "k 4 0 " + std::string(WALKTHROUGH) + "\n") ==
+                  "k\twon\t94\n",
+          "a later client is not answered");
+    check(waitForConnections(server, 0), "the last client is still counted");
+}
@@ -0,0 +1,76 @@
+/**
+ * @file solvertests.cpp
+ * @brief Tests of the shortest program solver.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "levelpack.h"
+#include "simulationcore.h"
+#include "solver.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const int MAX_STEPS = 10000;
+
+/**
+ * @brief checkShortest Solve a level, run the program found and make sure
+ * one block less finds nothing.
+ * @param name
+ * @param level
+ * @param blocks Length of the shortest program, worked out by hand for the
+ * small levels.
+ */
+void checkShortest(const std::string &name, const Level &level, int blocks) {
+    SolverOptions options;
+    options.maxSteps = MAX_STEPS;
+    for (int threads : {1, 4}) {
+        options.threads = threads;
+        SolverResult result = solveLevel(level, options);
+        std::string run = name + " on " + std::to_string(threads) +
+                " threads: ";
+        check(result.solved && (int)result.blocks.size() == blocks,
+              run + "no program of " + std::to_string(blocks) + " blocks");
+        if (!result.solved)
+            continue;
+        check(expandBlocks(result.blocks) == result.program,
+              run + "the blocks and the program differ");
+        SimulationCore simulation(level, result.program);
+        check(simulation.runUntilDone(MAX_STEPS).state == won,
+              run + "the program found does not win");
+    }
+    options.maxBlocks = blocks - 1;
+    check(!solveLevel(level, options).solved,
+          name + ": a program shorter than the shortest one");
+}
+
+} // namespace
+
+void testSolver() {
+    checkShortest("next to the cheese", textLevel(">C"), 2);
+    checkShortest("around a corner", textLevel(">*#\n#C#"), 4);
+    std::string error;
+    for (int number = 1; number <= 3; number++) {
+        Level level;
+        check(loadLevel(std::to_string(number), level, error),
+              "cannot load a built-in level: " + error);
+        SolverOptions options;
+        SolverResult result = solveLevel(level, options);
+        SimulationCore simulation(level, result.program);
+        check(result.solved &&
+                      simulation.runUntilDone(options.maxSteps).state == won,
+              "level " + std::to_string(number) + " is not solved");
+    }
+
+    // The cheese is walled off, nothing wins.
+    SolverOptions options;
+    options.maxBlocks = 4;
+    check(!solveLevel(textLevel(">#C"), options).solved,
+          "a level without a way to the cheese is solved");
+}
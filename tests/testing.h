@@ -0,0 +1,124 @@
+/**
+ * @file testing.h
+ * @brief Checks shared by the core tests, and the tests main.cpp runs.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef TESTING_H
+#define TESTING_H
+
+#include "constants.h"
+#include <string>
+#include <vector>
+
+typedef std::vector<std::vector<MapTile>> Level;
+
+/**
+ * @brief check Report a failed check with the name of the running test.
+ * @param passed
+ * @param what What went wrong.
+ */
+void check(bool passed, const std::string &what);
+
+/**
+ * @brief textLevel Parse a level drawn as text, failing the running test if
+ * it does not parse.
+ * @param text Rows separated by newlines.
+ * @return
+ */
+Level textLevel(const std::string &text);
+
+/**
+ * @brief textProgram Parse a program written as words, failing the running
+ * test if it does not parse.
+ * @param text
+ * @return
+ */
+std::vector<ProgramBlock> textProgram(const std::string &text);
+
+/**
+ * @brief temporaryPath Get a path for a scratch file of the running tests.
+ * The file is removed first if it exists.
+ * @param name
+ * @return
+ */
+std::string temporaryPath(const std::string &name);
+
+/**
+ * @brief fileSize Get the size of a file, -1 if it cannot be read.
+ * @param path
+ * @return
+ */
+long long fileSize(const std::string &path);
+
+/**
+ * @brief testRules Pin the game rules with runs whose outcome is worked out
+ * by hand.
+ */
+void testRules();
+
+/**
+ * @brief testEngines Check every engine against SimulationCore stepped one
+ * block at a time, on random levels and programs.
+ * @param rounds
+ * @param seed
+ */
+void testEngines(int rounds, unsigned seed);
+
+/**
+ * @brief testProfile Count the blocks of profiled runs and compare them with
+ * the blocks the runs report executing.
+ */
+void testProfile();
+
+/**
+ * @brief testResultCache Store, reload and compact a result cache file.
+ */
+void testResultCache();
+
+/**
+ * @brief testGenerator Check levels by hand against the solvability check,
+ * and make sure generated levels are winnable and reproducible.
+ */
+void testGenerator();
+
+/**
+ * @brief testHistory Step back and seek through runs, within the undo log and
+ * past it, and compare every tick with the way forward.
+ */
+void testHistory();
+
+/**
+ * @brief testLevelPacks Save and reload a level pack, and name its levels the
+ * way the command line tools do.
+ */
+void testLevelPacks();
+
+/**
+ * @brief testSolver Find the shortest programs of small levels and check that
+ * they win and that nothing shorter is found.
+ */
+void testSolver();
+
+/**
+ * @brief testTraces Replay every tick of a recorded run, and refuse trace
+ * files whose header does not fit them.
+ */
+void testTraces();
+
+/**
+ * @brief testVerifier Match heads and ends, report errors, and check edited
+ * chains again from the changed block on.
+ */
+void testVerifier();
+
+/**
+ * @brief testServer Grade jobs on the server, refuse levels it must not read
+ * and connections past its limit.
+ */
+void testServer();
+
+#endif // TESTING_H
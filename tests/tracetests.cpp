@@ -0,0 +1,132 @@
+/**
+ * @file tracetests.cpp
+ * @brief Tests of recorded traces and of reading damaged trace files.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "byteorder.h"
+#include "levelpack.h"
+#include "simulationcore.h"
+#include "trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int KEYFRAME_INTERVAL = 16;
+const int WIDTH_OFFSET = 8;
+const int HEIGHT_OFFSET = 12;
+
+std::vector<unsigned char> readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                      std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path,
+               const std::vector<unsigned char> &bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char *)bytes.data(), bytes.size());
+}
+
+void patch32(std::vector<unsigned char> &bytes, int offset,
+             std::uint32_t value) {
+    std::vector<unsigned char> field;
+    put32(field, value);
+    std::copy(field.begin(), field.end(), bytes.begin() + offset);
+}
+
+/**
+ * @brief sameState Compare a decoded frame with a simulation.
+ * @param frame
+ * @param simulation
+ * @return
+ */
+bool sameState(const TraceFrame &frame, const SimulationCore &simulation) {
+    const TileGrid &grid = simulation.getGrid();
+    if (frame.tick != simulation.getTickCount() ||
+            frame.robot != simulation.getRobotPos() ||
+            frame.robotDirection != simulation.getRobotDirection() ||
+            frame.state != simulation.getGameState() ||
+            (int)frame.map.size() != grid.getHeight())
+        return false;
+    for (int y = 0; y < grid.getHeight(); y++) {
+        if ((int)frame.map[y].size() != grid.getWidth())
+            return false;
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (frame.map[y][x] != grid.tileAt(x, y))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief rejects Check that a damaged copy of a trace does not open.
+ * @param bytes
+ * @param what
+ */
+void rejects(const std::vector<unsigned char> &bytes, const std::string &what) {
+    std::string path = temporaryPath("damaged.trace");
+    writeFile(path, bytes);
+    TraceReader reader;
+    std::string error;
+    check(!reader.open(path, error), "a trace with " + what + " opens");
+}
+
+} // namespace
+
+void testTraces() {
+    std::string error;
+    Level level;
+    check(loadLevel("4", level, error), "cannot load level 4: " + error);
+    std::vector<ProgramBlock> program = textProgram(
+            "while not wall move if wall right endif endwhile eat");
+
+    std::string path = temporaryPath("run.trace");
+    SimulationCore recorded(level, program);
+    TraceWriter writer(KEYFRAME_INTERVAL);
+    recorded.setTrace(&writer);
+    RunResult result = recorded.runUntilDone(1000);
+    check(result.state == won && result.steps == 94,
+          "the traced run does not win after 94 steps");
+    check(writer.save(path), "cannot write a trace");
+
+    TraceReader reader;
+    check(reader.open(path, error), "cannot open the trace: " + error);
+    check(reader.getLastTick() == 94, "the trace does not end on tick 94");
+    // Every tick, keyframes and the steps between them alike.
+    SimulationCore expected(level, program);
+    TraceFrame frame;
+    for (int tick = 0; tick <= 94; tick++) {
+        if (tick > 0)
+            expected.step();
+        check(reader.seek(tick, frame) && sameState(frame, expected),
+              "tick " + std::to_string(tick) + " is not replayed");
+    }
+    check(reader.seek(1000, frame) && sameState(frame, expected),
+          "a tick past the end is not clamped to the last one");
+
+    std::vector<unsigned char> bytes = readFile(path);
+    std::vector<unsigned char> damaged = bytes;
+    patch32(damaged, WIDTH_OFFSET, 0xffffffff);
+    patch32(damaged, HEIGHT_OFFSET, 0xffffffff);
+    rejects(damaged, "a map of -1 by -1");
+    damaged = bytes;
+    patch32(damaged, WIDTH_OFFSET, 0);
+    rejects(damaged, "a map without columns");
+    damaged = bytes;
+    patch32(damaged, WIDTH_OFFSET, 0x10000);
+    patch32(damaged, HEIGHT_OFFSET, 0x10000);
+    rejects(damaged, "a map larger than the file");
+    damaged.assign(bytes.begin(), bytes.begin() + 20);
+    rejects(damaged, "its end cut off");
+}
@@ -0,0 +1,131 @@
+/**
+ * @file verifiertests.cpp
+ * @brief Tests of the program verifier and of checking a changed chain again.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "testing.h"
+#include "programverifier.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int EDITS = 3000;
+const int MAX_CHAIN = 24;
+const unsigned SEED = 11;
+
+ChainBlock plain(int id, ProgramBlock type) {
+    return ChainBlock{id, type, blank, blank};
+}
+
+ChainBlock head(int id, ProgramBlock type, ProgramBlock facing) {
+    return ChainBlock{id, type, blank, facing};
+}
+
+/**
+ * @brief sameOutcome Compare everything two verifiers report.
+ * @param first
+ * @param second
+ * @return
+ */
+bool sameOutcome(const ProgramVerifier &first, const ProgramVerifier &second) {
+    return first.getProgram() == second.getProgram() &&
+            first.getBlockIds() == second.getBlockIds() &&
+            first.getJumps() == second.getJumps() &&
+            first.isValid() == second.isValid() &&
+            first.getErrorBlock() == second.getErrorBlock() &&
+            first.getErrorMessage() == second.getErrorMessage();
+}
+
+} // namespace
+
+void testVerifier() {
+    // begin, if wall, move, end if, while not cheese, left, end while
+    ProgramVerifier verifier;
+    std::vector<ChainBlock> chain = {
+            plain(10, beginBlock), head(11, ifStatement, conditionFacingWall),
+            plain(12, moveForward), plain(13, endIf),
+            ChainBlock{14, whileLoop, conditionNot, conditionFacingCheese},
+            plain(15, turnLeft), plain(16, endWhile)};
+    verifier.setChain(0, chain);
+    check(verifier.isValid() && verifier.getErrorBlock() == -1,
+          "a valid chain is refused: " + verifier.getErrorMessage());
+    std::vector<ProgramBlock> program = {
+            beginBlock, ifStatement, blank, conditionFacingWall, moveForward,
+            endIf, whileLoop, conditionNot, conditionFacingCheese, turnLeft,
+            endWhile};
+    check(verifier.getProgram() == program, "the program is not flattened");
+    std::vector<int> jumps = {-1, 5, -1, -1, -1, 1, 10, -1, -1, -1, 6};
+    check(verifier.getJumps() == jumps, "heads and ends are not matched");
+    check(verifier.getBlockIds() ==
+                  std::vector<int>{10, 11, 11, 11, 12, 13, 14, 14, 14, 15, 16},
+          "program indices do not map to their blocks");
+    check(verifier.positionOf(14) == 4 && verifier.positionOf(99) == -1,
+          "blocks are not found in the chain");
+    // Block ids of a flat program are its program indices.
+    ProgramVerifier flat(program);
+    check(flat.getProgram() == program && flat.getJumps() == jumps &&
+                  flat.isValid() && flat.getBlockIds()[7] == 6,
+          "a flat program is verified differently");
+
+    // Swap the end if for an end while: the while is then left open.
+    verifier.setChain(3, {plain(20, endWhile), chain[4], chain[5], chain[6]});
+    check(verifier.getErrorBlock() == 20 &&
+                  verifier.getErrorMessage() ==
+                          "No matched While statement for End While",
+          "a mismatched end is not reported");
+    check(verifier.positionOf(13) == -1 && verifier.positionOf(20) == 3,
+          "a replaced block is still found");
+    verifier.setChain(6, {});
+    check(verifier.getErrorBlock() == 20, "the first error is not kept");
+    verifier.setChain(3, {chain[3], chain[4], chain[5]});
+    check(verifier.getErrorBlock() == 14 &&
+                  verifier.getErrorMessage() == "Needs end statement",
+          "an open while is not reported");
+    verifier.setChain(1, {head(30, ifStatement, blank), plain(31, endIf)});
+    check(verifier.getErrorBlock() == 30 &&
+                  verifier.getErrorMessage() ==
+                          "Incomplete conditinal statement",
+          "a head without a condition is not reported");
+
+    // Random edits checked again from the changed block on must give what
+    // checking the whole chain from scratch gives.
+    std::mt19937 random(SEED);
+    const ProgramBlock types[] = {moveForward, turnLeft, turnRight, eatCheese,
+                                  ifStatement, endIf, whileLoop, endWhile};
+    const ProgramBlock facings[] = {conditionFacingBlock, conditionFacingWall,
+                                    conditionFacingPit, conditionFacingCheese,
+                                    blank};
+    ProgramVerifier edited;
+    std::vector<ChainBlock> current = {plain(0, beginBlock)};
+    edited.setChain(0, current);
+    int nextId = 1;
+    for (int edit = 0; edit < EDITS; edit++) {
+        int from = 1 + random() % current.size();
+        int length = random() % (MAX_CHAIN - from + 1);
+        current.resize(from);
+        for (int i = 0; i < length; i++) {
+            ChainBlock block = plain(nextId++, types[random() % 8]);
+            if (block.type == ifStatement || block.type == whileLoop) {
+                block.isNot = random() % 2 ? conditionNot : blank;
+                block.facing = facings[random() % 5];
+            }
+            current.push_back(block);
+        }
+        edited.setChain(from, std::vector<ChainBlock>(current.begin() + from,
+                                                      current.end()));
+        ProgramVerifier fresh;
+        fresh.setChain(0, current);
+        if (!sameOutcome(edited, fresh)) {
+            check(false, "edit " + std::to_string(edit) +
+                                 " differs from checking the whole chain");
+            break;
+        }
+    }
+}
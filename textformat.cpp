@@ -0,0 +1,211 @@
+/**
+ * @file textformat.cpp
+ * @brief Plain text levels and programs used by the headless tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "textformat.h"
+#include "programverifier.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+bool parseLevel(const std::string &text, std::vector<std::vector<MapTile>> &level,
+                std::string &error) {
+    std::vector<std::vector<MapTile>> parsed;
+    std::istringstream lines(text);
+    std::string line;
+    int starts = 0;
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+        std::vector<MapTile> row;
+        for (char c : line) {
+            switch (c) {
+            case '*':
+                row.push_back(ground);
+                break;
+            case '#':
+                row.push_back(wall);
+                break;
+            case '@':
+                row.push_back(block);
+                break;
+            case '0':
+                row.push_back(pit);
+                break;
+            case 'C':
+                row.push_back(cheese);
+                break;
+            case '>':
+                row.push_back(start);
+                starts++;
+                break;
+            default:
+                error = std::string("unknown tile '") + c + "'";
+                return false;
+            }
+        }
+        if (!parsed.empty() && row.size() != parsed[0].size()) {
+            error = "rows have different lengths";
+            return false;
+        }
+        parsed.push_back(row);
+    }
+    if (parsed.empty()) {
+        error = "empty level";
+        return false;
+    }
+    if (starts == 0) {
+        error = "level needs a start tile";
+        return false;
+    }
+    level = parsed;
+    return true;
+}
+
+std::string formatLevel(const std::vector<std::vector<MapTile>> &level) {
+    const char tileSymbols[] = {'>', '*', '#', 'C', '@', '0'};
+    std::string text;
+    for (const std::vector<MapTile> &row : level) {
+        for (MapTile tile : row) {
+            text += tileSymbols[tile];
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+bool parseProgram(const std::string &text, std::vector<ProgramBlock> &program,
+                  std::string &error) {
+    std::vector<ProgramBlock> parsed{beginBlock};
+    std::istringstream words(text);
+    std::string word;
+    while (words >> word) {
+        if (word == "begin" && parsed.size() == 1)
+            continue;
+        if (word == "move") {
+            parsed.push_back(moveForward);
+        } else if (word == "left") {
+            parsed.push_back(turnLeft);
+        } else if (word == "right") {
+            parsed.push_back(turnRight);
+        } else if (word == "eat") {
+            parsed.push_back(eatCheese);
+        } else if (word == "if" || word == "while") {
+            ProgramBlock head = word == "if" ? ifStatement : whileLoop;
+            ProgramBlock isNot = blank;
+            std::string condition;
+            if (!(words >> condition)) {
+                error = "Incomplete conditinal statement";
+                return false;
+            }
+            if (condition == "not") {
+                isNot = conditionNot;
+                words >> condition;
+            }
+            ProgramBlock facing;
+            if (condition == "wall") {
+                facing = conditionFacingWall;
+            } else if (condition == "block") {
+                facing = conditionFacingBlock;
+            } else if (condition == "pit") {
+                facing = conditionFacingPit;
+            } else if (condition == "cheese") {
+                facing = conditionFacingCheese;
+            } else {
+                error = "Incomplete conditinal statement";
+                return false;
+            }
+            parsed.push_back(head);
+            parsed.push_back(isNot);
+            parsed.push_back(facing);
+        } else if (word == "endif") {
+            parsed.push_back(endIf);
+        } else if (word == "endwhile") {
+            parsed.push_back(endWhile);
+        } else {
+            error = "unknown block '" + word + "'";
+            return false;
+        }
+    }
+    ProgramVerifier verifier(parsed);
+    if (!verifier.isValid()) {
+        error = verifier.getErrorMessage();
+        return false;
+    }
+    program = parsed;
+    return true;
+}
+
+std::string formatProgram(const std::vector<ProgramBlock> &program) {
+    std::string text;
+    for (ProgramBlock block : program) {
+        const char *word = nullptr;
+        switch (block) {
+        case moveForward:
+            word = "move";
+            break;
+        case turnLeft:
+            word = "left";
+            break;
+        case turnRight:
+            word = "right";
+            break;
+        case eatCheese:
+            word = "eat";
+            break;
+        case ifStatement:
+            word = "if";
+            break;
+        case whileLoop:
+            word = "while";
+            break;
+        case endIf:
+            word = "endif";
+            break;
+        case endWhile:
+            word = "endwhile";
+            break;
+        case conditionNot:
+            word = "not";
+            break;
+        case conditionFacingWall:
+            word = "wall";
+            break;
+        case conditionFacingBlock:
+            word = "block";
+            break;
+        case conditionFacingPit:
+            word = "pit";
+            break;
+        case conditionFacingCheese:
+            word = "cheese";
+            break;
+        default:
+            break;
+        }
+        if (!word)
+            continue;
+        if (!text.empty())
+            text += ' ';
+        text += word;
+    }
+    return text;
+}
+
+bool readFile(const std::string &path, std::string &contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file textformat.h
+ * @brief Header file for textformat.cpp, plain text levels and programs used
+ * by the headless tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef TEXTFORMAT_H
+#define TEXTFORMAT_H
+
+#include "constants.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief parseLevel Parse a level drawn with the same characters
+ * SimulationCore::toString prints: '*' ground, '#' wall, '@' block, '0' pit,
+ * 'C' cheese and '>' a start tile. Lines must all be the same length, and
+ * every start tile holds a robot.
+ * @param text
+ * @param level Receives the parsed level.
+ * @param error Receives a message when parsing fails.
+ * @return Whether the level was parsed.
+ */
+bool parseLevel(const std::string &text, std::vector<std::vector<MapTile>> &level,
+                std::string &error);
+
+/**
+ * @brief formatLevel Draw a level with the characters parseLevel reads.
+ * @param level
+ * @return One line per row.
+ */
+std::string formatLevel(const std::vector<std::vector<MapTile>> &level);
+
+/**
+ * @brief parseProgram Parse a whitespace separated program, for example
+ * "while not wall move if wall right endif endwhile eat". A leading begin
+ * block is added. Brackets are checked by ProgramVerifier, as in the editor.
+ * @param text
+ * @param program Receives the parsed program.
+ * @param error Receives a message when parsing fails.
+ * @return Whether the program was parsed.
+ */
+bool parseProgram(const std::string &text, std::vector<ProgramBlock> &program,
+                  std::string &error);
+
+/**
+ * @brief formatProgram Write a program in the form parseProgram reads, without
+ * the begin block.
+ * @param program
+ * @return
+ */
+std::string formatProgram(const std::vector<ProgramBlock> &program);
+
+/**
+ * @brief readFile Read a whole file into a string.
+ * @param path
+ * @param contents
+ * @return Whether the file could be read.
+ */
+bool readFile(const std::string &path, std::string &contents);
+
+#endif // TEXTFORMAT_H
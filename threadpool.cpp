@@ -0,0 +1,110 @@
+/**
+ * @file threadpool.cpp
+ * @brief A work-stealing thread pool for the headless tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "threadpool.h"
+
+namespace {
+// The pool and worker index of the current thread, if it is a worker.
+thread_local WorkStealingPool *currentPool = nullptr;
+thread_local int currentIndex = -1;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : pending(0), queued(0), nextWorker(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount <= 0)
+            threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    pending++;
+    int index = currentPool == this
+            ? currentIndex
+            : (int)(nextWorker++ % workers.size());
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    queued++;
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+bool WorkStealingPool::takeTask(int index, std::function<void()> &task) {
+    // Newest task from our own deque first.
+    {
+        Worker &own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    // Then the oldest task of any other worker.
+    for (unsigned long long offset = 1; offset < workers.size(); offset++) {
+        Worker &victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int index) {
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        std::function<void()> task;
+        if (takeTask(index, task)) {
+            task();
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping)
+            return;
+        if (queued > 0)
+            continue;
+        workAvailable.wait(lock);
+    }
+}
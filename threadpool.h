@@ -0,0 +1,91 @@
+/**
+ * @file threadpool.h
+ * @brief Header file for threadpool.cpp, a work-stealing thread pool for the
+ * headless tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Each worker owns a deque of tasks. Tasks submitted from a worker go to
+/// the back of its own deque and are popped LIFO, so recursive searches stay
+/// depth first and cache friendly. Idle workers steal from the front of
+/// other deques, taking the oldest and usually largest pieces of work.
+class WorkStealingPool {
+public:
+    /**
+   * @brief WorkStealingPool Start the workers.
+   * @param threadCount Number of workers, 0 picks one per hardware thread.
+   */
+    explicit WorkStealingPool(int threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+   * @brief submit Queue a task. Safe to call from inside a task.
+   * @param task
+   */
+    void submit(std::function<void()> task);
+
+    /**
+   * @brief wait Block until every submitted task, including tasks they
+   * submitted, has finished.
+   */
+    void wait();
+
+    /**
+   * @brief getThreadCount Get the number of workers.
+   * @return
+   */
+    int getThreadCount() const { return (int)threads.size(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    // Tasks queued or running.
+    std::atomic<int> pending;
+    // Tasks sitting in some deque, checked so sleeping workers never miss one.
+    std::atomic<int> queued;
+    // Round robin target for tasks submitted from outside the pool.
+    std::atomic<unsigned> nextWorker;
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    bool stopping;
+
+    /**
+   * @brief run Worker loop.
+   * @param index
+   */
+    void run(int index);
+
+    /**
+   * @brief takeTask Pop from our own deque or steal from another.
+   * @param index
+   * @param task
+   * @return Whether a task was found.
+   */
+    bool takeTask(int index, std::function<void()> &task);
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,84 @@
+/**
+ * @file tilegrid.cpp
+ * @brief The contiguous map the interpreter runs on.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "tilegrid.h"
+#include <vector>
+
+TileGrid::TileGrid() : width(0), height(0), stride(2), offsets{-2, 2, 1, -1} {}
+
+TileGrid::TileGrid(LevelView map)
+    : width(map.getWidth()), height(map.getHeight()),
+      stride(width + 2), cells((width + 2) * (height + 2), tileOutside),
+      offsets{-stride, stride, 1, -1} {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            cells[index(x, y)] = tileBits(map.at(x, y));
+        }
+    }
+}
+
+MapTile TileGrid::tileAt(int x, int y) const {
+    return tileFromBits(cells[index(x, y)]);
+}
+
+std::vector<std::vector<MapTile>> TileGrid::toMap() const {
+    std::vector<std::vector<MapTile>> map(height, std::vector<MapTile>(width));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            map[y][x] = tileAt(x, y);
+        }
+    }
+    return map;
+}
+
+unsigned char tileBits(MapTile tile) {
+    switch (tile) {
+    case wall:
+        return tileWall;
+    case block:
+        return tileBlock;
+    case pit:
+        return tilePit;
+    case cheese:
+        return tileCheese;
+    case start:
+    case ground:
+        break;
+    }
+    return 0;
+}
+
+MapTile tileFromBits(unsigned char bits) {
+    // The cheese is drawn on top of a block pushed onto it.
+    if (bits & tileCheese)
+        return cheese;
+    if (bits & tileWall)
+        return wall;
+    if (bits & tileBlock)
+        return block;
+    if (bits & tilePit)
+        return pit;
+    return ground;
+}
+
+unsigned char conditionMask(ProgramBlock condition) {
+    switch (condition) {
+    case conditionFacingBlock:
+        return tileBlock;
+    case conditionFacingWall:
+        return tileWall;
+    case conditionFacingPit:
+        return tilePit;
+    case conditionFacingCheese:
+        return tileCheese;
+    default:
+        break;
+    }
+    return 0;
+}
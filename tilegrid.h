@@ -0,0 +1,210 @@
+/**
+ * @file tilegrid.h
+ * @brief Header file for tilegrid.cpp, the contiguous map the interpreter
+ * runs on.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef TILEGRID_H
+#define TILEGRID_H
+
+#include "constants.h"
+#include <vector>
+
+/// Class bits stored for every cell. Ground is a cell with no bits set.
+enum TileBits : unsigned char {
+    tileWall = 1,
+    tileBlock = 2,
+    tilePit = 4,
+    tileCheese = 8,
+    // The sentinel ring around the map.
+    tileOutside = 16,
+};
+
+/// Cells the robot cannot walk into without pushing something.
+const unsigned char tileSolid = tileWall | tileBlock | tilePit | tileOutside;
+
+/// Row-major tile grid surrounded by a one cell ring of tileOutside, so a
+/// neighbour of any map cell is always a valid index and edges need no bounds
+/// checks. Each cell packs its class bits into one byte, so a condition is a
+/// single mask test.
+class TileGrid {
+private:
+    int width;
+    int height;
+    // Cells per padded row.
+    int stride;
+    std::vector<unsigned char> cells;
+    // Index offset of the neighbour in each direction.
+    int offsets[4];
+
+public:
+    TileGrid();
+
+    /**
+   * @brief TileGrid Build a grid from a level. Start tiles become ground and
+   * cheese tiles become ground with tileCheese set.
+   * @param map
+   */
+    explicit TileGrid(LevelView map);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }
+
+    /**
+   * @brief index Get the cell index of a map coordinate.
+   * @param x
+   * @param y
+   * @return
+   */
+    int index(int x, int y) const { return (y + 1) * stride + x + 1; }
+
+    /**
+   * @brief getX Get the map column of a cell index.
+   * @param index
+   * @return
+   */
+    int getX(int index) const { return index % stride - 1; }
+
+    /**
+   * @brief getY Get the map row of a cell index.
+   * @param index
+   * @return
+   */
+    int getY(int index) const { return index / stride - 1; }
+
+    /**
+   * @brief offset Get the index offset of the neighbour in a direction.
+   * @param dir
+   * @return
+   */
+    int offset(direction dir) const { return offsets[dir]; }
+
+    /**
+   * @brief at Get the class bits of a cell.
+   * @param index
+   * @return
+   */
+    unsigned char at(int index) const { return cells[index]; }
+
+    /**
+   * @brief set Replace the class bits of a cell.
+   * @param index
+   * @param bits
+   */
+    void set(int index, unsigned char bits) { cells[index] = bits; }
+
+    /**
+   * @brief data Get the class bits of every cell, for loops that read many
+   * cells at once.
+   * @return
+   */
+    const unsigned char *data() const { return cells.data(); }
+
+    /**
+   * @brief tileAt Get the MapTile shown for a map coordinate.
+   * @param x
+   * @param y
+   * @return
+   */
+    MapTile tileAt(int x, int y) const;
+
+    /**
+   * @brief toMap Convert the grid back into the nested vector the canvas
+   * draws.
+   * @return
+   */
+    std::vector<std::vector<MapTile>> toMap() const;
+};
+
+/**
+ * @brief tileBits Get the class bits of a level tile. Start tiles are ground.
+ * @param tile
+ * @return
+ */
+unsigned char tileBits(MapTile tile);
+
+/**
+ * @brief tileFromBits Get the MapTile shown for a cell's class bits.
+ * @param bits
+ * @return
+ */
+MapTile tileFromBits(unsigned char bits);
+
+/**
+ * @brief conditionMask Get the class bits a facing condition tests for.
+ * @param condition
+ * @return
+ */
+unsigned char conditionMask(ProgramBlock condition);
+
+/// What a move forward does. Decided by moveOutcome so every engine moves
+/// and pushes the same way.
+enum MoveOutcome {
+    // Nothing moves.
+    moveBlocked,
+    // The robot walks into the free cell in front of it.
+    moveWalks,
+    // The robot walks into a pit and is lost.
+    moveFalls,
+    // The robot pushes the block in front of it one cell on and follows.
+    movePushes,
+    // The pushed block falls into the pit behind it, the pit stays, and the
+    // robot follows.
+    moveDropsBlock,
+};
+
+/**
+ * @brief moveOutcome Decide what a move forward does. Wall and outside bits
+ * always stop the move, so an engine may add tileWall to a cell it wants to
+ * treat as taken.
+ * @param facing Class bits of the cell in front of the robot.
+ * @param behind Class bits of the cell behind that one. Only read when facing
+ * holds a block, so callers pass 0 otherwise and never look past the ring.
+ * @return
+ */
+inline MoveOutcome moveOutcome(unsigned char facing, unsigned char behind) {
+    if (!(facing & tileSolid))
+        return moveWalks;
+    if (facing & (tileWall | tileOutside))
+        return moveBlocked;
+    if (facing & tilePit)
+        return moveFalls;
+    if (!(behind & tileSolid))
+        return movePushes;
+    if (behind & (tileWall | tileOutside | tileBlock))
+        return moveBlocked;
+    return moveDropsBlock;
+}
+
+/**
+ * @brief conditionHolds Decide a facing condition. Nothing is sensed past the
+ * edge of the map, even with "Not".
+ * @param facing Class bits of the cell in front of the robot.
+ * @param mask Class bits the condition tests for.
+ * @param negate Whether the condition is preceded by "Not".
+ * @return
+ */
+inline bool conditionHolds(unsigned char facing, unsigned char mask,
+                           bool negate) {
+    return !(facing & tileOutside) && ((facing & mask) != 0) != negate;
+}
+
+/**
+ * @brief rotate Turn a direction clockwise.
+ * @param dir
+ * @param quarterTurns
+ * @return
+ */
+inline direction rotate(direction dir, int quarterTurns) {
+    static const direction clockwise[] = {north, east, south, west};
+    // Position of each direction in clockwise, indexed by direction.
+    static const int position[] = {0, 2, 1, 3};
+    return clockwise[(position[dir] + quarterTurns) % 4];
+}
+
+#endif // TILEGRID_H
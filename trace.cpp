@@ -0,0 +1,246 @@
+/**
+ * @file trace.cpp
+ * @brief Binary recordings of a run that can be scrubbed without simulating
+ * again.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "trace.h"
+#include "byteorder.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// File layout, all integers little endian:
+//   header    "ECTR", version u32, width u32, height u32
+//   entries   kind u8 ('S' step or 'K' keyframe), tick u32, block i32,
+//             robot x i32, robot y i32, direction u8, state u8, then
+//             for a step: change count u32 and per change x i32, y i32, tile u8
+//             for a keyframe: width * height tiles, one byte each
+//   index     per keyframe: tick u32, offset u64
+//   footer    keyframe count u32, last tick u32, "ECTI"
+namespace {
+
+const char headerMagic[] = "ECTR";
+const char footerMagic[] = "ECTI";
+const std::uint32_t traceVersion = 1;
+const int headerSize = 16;
+const int frameSize = 19;
+const int changeSize = 9;
+const int indexEntrySize = 12;
+const int footerSize = 12;
+
+void put8(std::vector<unsigned char> &buffer, unsigned value) {
+    buffer.push_back(value & 0xff);
+}
+
+} // namespace
+
+TraceWriter::TraceWriter(int newKeyframeInterval)
+    : keyframeInterval(newKeyframeInterval > 0 ? newKeyframeInterval : 1),
+      width(0), height(0), lastTick(0) {}
+
+void TraceWriter::begin(const SimulationCore &simulation) {
+    buffer.clear();
+    keyframes.clear();
+    width = simulation.getGrid().getWidth();
+    height = simulation.getGrid().getHeight();
+    buffer.insert(buffer.end(), headerMagic, headerMagic + 4);
+    put32(buffer, traceVersion);
+    put32(buffer, width);
+    put32(buffer, height);
+
+    keyframes.emplace_back(simulation.getTickCount(), buffer.size());
+    appendFrame('K', simulation);
+}
+
+void TraceWriter::record(const SimulationCore &simulation) {
+    if (simulation.getTickCount() % keyframeInterval == 0) {
+        keyframes.emplace_back(simulation.getTickCount(), buffer.size());
+        appendFrame('K', simulation);
+        return;
+    }
+    appendFrame('S', simulation);
+}
+
+void TraceWriter::appendFrame(unsigned char kind,
+                              const SimulationCore &simulation) {
+    Point robot = simulation.getRobotPos();
+    lastTick = simulation.getTickCount();
+    put8(buffer, kind);
+    put32(buffer, lastTick);
+    put32(buffer, simulation.getCurrentBlock());
+    put32(buffer, robot.x);
+    put32(buffer, robot.y);
+    put8(buffer, simulation.getRobotDirection());
+    put8(buffer, simulation.getGameState());
+
+    if (kind == 'K') {
+        const TileGrid &grid = simulation.getGrid();
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                put8(buffer, grid.tileAt(x, y));
+            }
+        }
+        return;
+    }
+    const std::vector<TileChange> &changes = simulation.getChanges();
+    put32(buffer, changes.size());
+    for (const TileChange &change : changes) {
+        put32(buffer, change.x);
+        put32(buffer, change.y);
+        put8(buffer, change.tile);
+    }
+}
+
+bool TraceWriter::save(const std::string &path) const {
+    std::vector<unsigned char> index;
+    for (const auto &keyframe : keyframes) {
+        put32(index, keyframe.first);
+        put64(index, keyframe.second);
+    }
+    put32(index, keyframes.size());
+    put32(index, lastTick);
+    index.insert(index.end(), footerMagic, footerMagic + 4);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file.write((const char *)buffer.data(), buffer.size());
+    file.write((const char *)index.data(), index.size());
+    return (bool)file;
+}
+
+TraceReader::TraceReader()
+    : data(nullptr), size(0), width(0), height(0), lastTick(0),
+      indexOffset(0), keyframeCount(0) {}
+
+TraceReader::~TraceReader() { close(); }
+
+void TraceReader::close() {
+    file.close();
+    data = nullptr;
+    size = 0;
+}
+
+bool TraceReader::open(const std::string &path, std::string &error) {
+    close();
+    if (!file.open(path)) {
+        error = "cannot read " + path;
+        return false;
+    }
+    data = file.getData();
+    size = file.getSize();
+
+    if (size < (std::uint64_t)headerSize + footerSize ||
+            std::memcmp(data, headerMagic, 4) != 0 ||
+            std::memcmp(data + size - 4, footerMagic, 4) != 0) {
+        close();
+        error = path + " is not a trace";
+        return false;
+    }
+    if (get32(data + 4) != traceVersion) {
+        close();
+        error = path + " was written by another version";
+        return false;
+    }
+    width = get32(data + 8);
+    height = get32(data + 12);
+    // Every keyframe holds the whole map, so a map larger than the file
+    // cannot be right, and checking that here keeps width * height in range.
+    if (width <= 0 || height <= 0 ||
+            (std::uint64_t)width * height > size - headerSize - footerSize) {
+        close();
+        error = path + " has an invalid map size";
+        return false;
+    }
+    keyframeCount = get32(data + size - footerSize);
+    lastTick = get32(data + size - footerSize + 4);
+    std::uint64_t indexSize = (std::uint64_t)keyframeCount * indexEntrySize;
+    if (keyframeCount == 0 || indexSize > size - headerSize - footerSize) {
+        close();
+        error = path + " has no keyframes";
+        return false;
+    }
+    indexOffset = size - footerSize - indexSize;
+    return true;
+}
+
+void TraceReader::keyframeAt(int index, int &tick, std::uint64_t &offset) const {
+    const unsigned char *entry = data + indexOffset + index * indexEntrySize;
+    tick = get32(entry);
+    offset = get64(entry + 4);
+}
+
+bool TraceReader::seek(int tick, TraceFrame &frame) const {
+    if (!data)
+        return false;
+
+    // Last keyframe at or before the tick.
+    int low = 0;
+    int high = keyframeCount - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        int keyframeTick;
+        std::uint64_t offset;
+        keyframeAt(middle, keyframeTick, offset);
+        if (keyframeTick <= tick) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    int keyframeTick;
+    std::uint64_t position;
+    keyframeAt(low, keyframeTick, position);
+
+    std::uint64_t mapSize = (std::uint64_t)width * height;
+    if (position > indexOffset ||
+            position + frameSize + mapSize > indexOffset ||
+            data[position] != 'K')
+        return false;
+    frame.map.assign(height, std::vector<MapTile>(width));
+    bool keyframe = true;
+    while (position + frameSize <= indexOffset) {
+        const unsigned char *entry = data + position;
+        int entryTick = get32(entry + 1);
+        if (!keyframe && (entry[0] == 'K' || entryTick > tick))
+            break;
+        frame.tick = entryTick;
+        frame.block = (std::int32_t)get32(entry + 5);
+        frame.robot = Point{(std::int32_t)get32(entry + 9),
+                            (std::int32_t)get32(entry + 13)};
+        frame.robotDirection = (direction)entry[17];
+        frame.state = (gameState)entry[18];
+        position += frameSize;
+
+        if (keyframe) {
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    frame.map[y][x] = (MapTile)data[position++];
+                }
+            }
+            keyframe = false;
+            continue;
+        }
+        if (position + 4 > indexOffset)
+            return false;
+        std::uint32_t changes = get32(data + position);
+        position += 4;
+        if (position + (std::uint64_t)changes * changeSize > indexOffset)
+            return false;
+        for (std::uint32_t i = 0; i < changes; i++) {
+            int x = get32(data + position);
+            int y = get32(data + position + 4);
+            if (x >= 0 && x < width && y >= 0 && y < height)
+                frame.map[y][x] = (MapTile)data[position + 8];
+            position += changeSize;
+        }
+    }
+    return true;
+}
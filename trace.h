@@ -0,0 +1,155 @@
+/**
+ * @file trace.h
+ * @brief Header file for trace.cpp, binary recordings of a run that can be
+ * scrubbed without simulating again.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "constants.h"
+#include "mappedfile.h"
+#include "simulationcore.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// State of a recorded run at one tick.
+struct TraceFrame {
+    int tick;
+    // Source block executed on this tick, as reported by runningBlock.
+    int block;
+    // (-1, -1) once the robot is lost.
+    Point robot;
+    direction robotDirection;
+    gameState state;
+    std::vector<std::vector<MapTile>> map;
+};
+
+/// Records a run into an append-only byte buffer. Every step appends its
+/// tick, block, robot and changed tiles; every keyframeInterval ticks a full
+/// copy of the map is appended instead, so a reader never replays more than
+/// keyframeInterval steps. save() writes the buffer followed by an index of
+/// the keyframes.
+class TraceWriter {
+private:
+    int keyframeInterval;
+    int width;
+    int height;
+    int lastTick;
+    std::vector<unsigned char> buffer;
+    // Tick and buffer offset of every keyframe.
+    std::vector<std::pair<int, std::uint64_t>> keyframes;
+
+public:
+    /**
+   * @brief TraceWriter Create an empty trace.
+   * @param newKeyframeInterval Ticks between two keyframes.
+   */
+    explicit TraceWriter(int newKeyframeInterval = 256);
+
+    /**
+   * @brief begin Start the trace with the state before the first step.
+   * @param simulation
+   */
+    void begin(const SimulationCore &simulation);
+
+    /**
+   * @brief record Append the step the simulation just executed.
+   * @param simulation
+   */
+    void record(const SimulationCore &simulation);
+
+    /**
+   * @brief getBuffer Get the recorded entries, without the index.
+   * @return
+   */
+    const std::vector<unsigned char> &getBuffer() const { return buffer; }
+
+    /**
+   * @brief getLastTick Get the tick of the newest entry.
+   * @return
+   */
+    int getLastTick() const { return lastTick; }
+
+    /**
+   * @brief save Write the trace and its keyframe index to a file.
+   * @param path
+   * @return Whether the file was written.
+   */
+    bool save(const std::string &path) const;
+
+private:
+    /**
+   * @brief appendFrame Append the fields shared by steps and keyframes.
+   * @param kind
+   * @param simulation
+   */
+    void appendFrame(unsigned char kind, const SimulationCore &simulation);
+};
+
+/// Reads a saved trace through a memory map. seek() finds the last keyframe
+/// at or before a tick by binary search over the index and replays the few
+/// steps after it.
+class TraceReader {
+private:
+    MappedFile file;
+    // Contents of file while a trace is open.
+    const unsigned char *data;
+    std::uint64_t size;
+    int width;
+    int height;
+    int lastTick;
+    // Start of the keyframe index, also the end of the entries.
+    std::uint64_t indexOffset;
+    int keyframeCount;
+
+public:
+    TraceReader();
+    ~TraceReader();
+
+    TraceReader(const TraceReader &) = delete;
+    TraceReader &operator=(const TraceReader &) = delete;
+
+    /**
+   * @brief open Map a trace file.
+   * @param path
+   * @param error Receives a message when the file is not a valid trace.
+   * @return Whether the trace was opened.
+   */
+    bool open(const std::string &path, std::string &error);
+
+    /**
+   * @brief getLastTick Get the tick of the last recorded step.
+   * @return
+   */
+    int getLastTick() const { return lastTick; }
+
+    /**
+   * @brief seek Reconstruct the run at a tick, clamped to the recorded range.
+   * @param tick
+   * @param frame Receives the state at the tick.
+   * @return Whether the trace could be decoded.
+   */
+    bool seek(int tick, TraceFrame &frame) const;
+
+private:
+    /**
+   * @brief close Release the mapping.
+   */
+    void close();
+
+    /**
+   * @brief keyframeAt Get the tick and offset of a keyframe from the index.
+   * @param index
+   * @param tick
+   * @param offset
+   */
+    void keyframeAt(int index, int &tick, std::uint64_t &offset) const;
+};
+
+#endif // TRACE_H
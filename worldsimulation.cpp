@@ -0,0 +1,203 @@
+/**
+ * @file worldsimulation.cpp
+ * @brief Runs a program on a chunked world of any size.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "worldsimulation.h"
+#include "tilegrid.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Coordinate steps for north, south, east and west.
+const int stepX[] = {0, 0, 1, -1};
+const int stepY[] = {-1, 1, 0, 0};
+
+std::uint64_t cellKey(int x, int y) {
+    return ((std::uint64_t)(std::uint32_t)y << 32) | (std::uint32_t)x;
+}
+
+ChunkedMap levelWorld(const std::vector<std::vector<MapTile>> &level) {
+    int width = level.empty() ? 0 : level[0].size();
+    ChunkedMap world(width, level.size(), 0, tileOutside);
+    for (int y = 0; y < (int)level.size(); y++) {
+        for (int x = 0; x < width; x++) {
+            world.set(x, y, tileBits(level[y][x]));
+        }
+    }
+    return world;
+}
+
+Point levelStart(const std::vector<std::vector<MapTile>> &level) {
+    // Without a start tile the robot starts in the top left corner.
+    Point start{0, 0};
+    for (int y = 0; y < (int)level.size(); y++) {
+        for (int x = 0; x < (int)level[y].size(); x++) {
+            if (level[y][x] == MapTile::start)
+                start = Point{x, y};
+        }
+    }
+    return start;
+}
+
+} // namespace
+
+WorldSimulation::WorldSimulation(const ChunkedMap &newWorld, int startX,
+                                 int startY, direction newDirection,
+                                 const std::vector<ProgramBlock> &newProgram)
+    : state(notEnded), world(newWorld), code(compileProgram(newProgram)),
+      programSize(newProgram.size()), robotX(startX), robotY(startY),
+      robotDirection(newDirection), tickCount(0), pc(0), currentBlock(0),
+      detectCycles(true), blockHash(0), knownUntil(0), repeatTick(-1) {}
+
+WorldSimulation::WorldSimulation(const std::vector<std::vector<MapTile>> &level,
+                                 const std::vector<ProgramBlock> &newProgram)
+    : WorldSimulation(levelWorld(level), levelStart(level).x,
+                      levelStart(level).y, east, newProgram) {}
+
+void WorldSimulation::step() {
+    if (state != notEnded) {
+        changes.clear();
+        return;
+    }
+    if (detectCycles && !origin)
+        origin = std::make_shared<const WorldSimulation>(*this);
+    advance();
+    // The run is deterministic, so reaching a state twice means it loops.
+    // Up to knownUntil a look ahead already found out, past it look twice as
+    // far.
+    if (!detectCycles || state != notEnded)
+        return;
+    if (tickCount > knownUntil)
+        lookFurther(lookAheadTick(tickCount));
+    if (tickCount == repeatTick)
+        state = nonTerminating;
+}
+
+RunResult WorldSimulation::runUntilDone(int maxSteps) {
+    int end = maxSteps;
+    if (detectCycles && state == notEnded && tickCount < maxSteps) {
+        if (!origin)
+            origin = std::make_shared<const WorldSimulation>(*this);
+        if (knownUntil < maxSteps)
+            lookFurther(maxSteps);
+        // Nothing repeats before repeatTick, so no state needs checking.
+        if (repeatTick >= 0)
+            end = std::min(repeatTick, maxSteps);
+    }
+    while (state == notEnded && tickCount < end) {
+        advance();
+    }
+    if (detectCycles && state == notEnded && tickCount == repeatTick)
+        state = nonTerminating;
+    return RunResult{state, tickCount};
+}
+
+void WorldSimulation::advance() {
+    changes.clear();
+    if (pc == (int)code.size()) {
+        tickCount++;
+        currentBlock = programSize;
+        setLost();
+        return;
+    }
+    execute(code[pc]);
+}
+
+void WorldSimulation::lookFurther(int tick) {
+    RepeatSearch found = findRepeat(*origin, tick);
+    knownUntil = found.knownUntil;
+    repeatTick = found.repeatTick;
+}
+
+void WorldSimulation::execute(const Instruction &instruction) {
+    tickCount++;
+    currentBlock = instruction.block;
+    pc = instruction.first + 1;
+
+    switch (instruction.op) {
+    case opMove:
+        moveRobot();
+        break;
+    case opTurnLeft:
+        robotDirection = rotate(robotDirection, 3);
+        break;
+    case opTurnRight:
+        robotDirection = rotate(robotDirection, 1);
+        break;
+    case opEat: {
+        unsigned char bits = world.at(robotX, robotY);
+        if (bits & tileCheese) {
+            setTile(robotX, robotY, bits & ~tileCheese);
+            state = won;
+        }
+        break;
+    }
+    case opBranch: {
+        unsigned char facing = world.at(robotX + stepX[robotDirection],
+                                        robotY + stepY[robotDirection]);
+        if (!conditionHolds(facing, instruction.mask, instruction.negate))
+            pc = instruction.target;
+        break;
+    }
+    case opJump:
+        pc = instruction.target;
+        break;
+    default:
+        break;
+    }
+}
+
+void WorldSimulation::moveRobot() {
+    int newX = robotX + stepX[robotDirection];
+    int newY = robotY + stepY[robotDirection];
+    int boxX = newX + stepX[robotDirection];
+    int boxY = newY + stepY[robotDirection];
+    unsigned char facing = world.at(newX, newY);
+    unsigned char behind = facing & tileBlock ? world.at(boxX, boxY) : 0;
+
+    switch (moveOutcome(facing, behind)) {
+    case moveFalls:
+        setLost();
+        return;
+    case movePushes:
+        setTile(boxX, boxY, behind | tileBlock);
+        setTile(newX, newY, facing & ~tileBlock);
+        break;
+    case moveDropsBlock:
+        setTile(newX, newY, facing & ~tileBlock);
+        break;
+    case moveWalks:
+        break;
+    case moveBlocked:
+        return;
+    }
+    robotX = newX;
+    robotY = newY;
+}
+
+void WorldSimulation::setLost() {
+    state = lost;
+    robotX = -1;
+    robotY = -1;
+}
+
+void WorldSimulation::setTile(int x, int y, unsigned char bits) {
+    if ((world.at(x, y) ^ bits) & tileBlock)
+        blockHash ^= mixHash(cellKey(x, y) << 1 | 1);
+    world.set(x, y, bits);
+    changes.push_back(TileChange{x, y, tileFromBits(bits)});
+}
+
+std::uint64_t WorldSimulation::getStateHash() const {
+    return blockHash ^
+            mixHash(mixHash(cellKey(robotX, robotY) * 4 + robotDirection) ^ pc);
+}
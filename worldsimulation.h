@@ -0,0 +1,146 @@
+/**
+ * @file worldsimulation.h
+ * @brief Header file for worldsimulation.cpp, runs a program on a chunked
+ * world of any size.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef WORLDSIMULATION_H
+#define WORLDSIMULATION_H
+
+#include "bytecode.h"
+#include "chunkedmap.h"
+#include "constants.h"
+#include "cyclesearch.h"
+#include "simulationcore.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Runs a program on a ChunkedMap of TileGrid class bits, with the robot
+/// addressed by its coordinates instead of a cell index. Steps behave exactly
+/// like SimulationCore::step. Only the tiles the robot looks at are ever
+/// loaded, so the world can be far bigger than memory. The map hash only
+/// covers blocks that moved, never the whole world.
+class WorldSimulation {
+private:
+    gameState state;
+    ChunkedMap world;
+    std::vector<Instruction> code;
+    int programSize;
+    // Robot coordinates, -1 once lost.
+    int robotX;
+    int robotY;
+    direction robotDirection;
+    int tickCount;
+    // Index into code of the next instruction to execute.
+    int pc;
+    // Source block of the last executed instruction.
+    int currentBlock;
+    // Tiles changed by the last step.
+    std::vector<TileChange> changes;
+    bool detectCycles;
+    // XOR of a key for every cell whose block was moved in or out.
+    std::uint64_t blockHash;
+    // Last tick looked ahead to. No state repeats before it except at
+    // repeatTick, which is -1 if none does.
+    int knownUntil;
+    int repeatTick;
+    // The world before the first step, where looking ahead starts from.
+    // nullptr until then.
+    std::shared_ptr<const WorldSimulation> origin;
+
+public:
+    /**
+   * @brief WorldSimulation Constructs a simulation on a world.
+   * @param newWorld Class bits of every tile, tileOutside past the edge.
+   * @param startX
+   * @param startY
+   * @param newDirection
+   * @param newProgram
+   */
+    WorldSimulation(const ChunkedMap &newWorld, int startX, int startY,
+                    direction newDirection,
+                    const std::vector<ProgramBlock> &newProgram);
+
+    /**
+   * @brief WorldSimulation Constructs a simulation on a level, starting on
+   * its start tile facing east.
+   * @param level
+   * @param newProgram
+   */
+    WorldSimulation(const std::vector<std::vector<MapTile>> &level,
+                    const std::vector<ProgramBlock> &newProgram);
+
+    /**
+   * @brief step Execute next block.
+   */
+    void step();
+
+    /**
+   * @brief runUntilDone Step until the game ends or maxSteps steps have been
+   * executed in total. Looks ahead for a repeated state once, so the steps
+   * themselves check nothing.
+   * @param maxSteps
+   * @return The final state, notEnded if the step limit was hit.
+   */
+    RunResult runUntilDone(int maxSteps);
+
+    /**
+   * @brief setCycleDetection Turn off looking for repeated states, which
+   * runs the world a second time from its start.
+   * @param enabled
+   */
+    void setCycleDetection(bool enabled) { detectCycles = enabled; }
+
+    /**
+   * @brief getRobotPos Get robot's position.
+   * @return
+   */
+    Point getRobotPos() const { return Point{robotX, robotY}; }
+
+    direction getRobotDirection() const { return robotDirection; }
+    gameState getGameState() const { return state; }
+    int getTickCount() const { return tickCount; }
+    int getCurrentBlock() const { return currentBlock; }
+
+    /**
+   * @brief getWorld Get the world as the run left it.
+   * @return
+   */
+    const ChunkedMap &getWorld() const { return world; }
+
+    /**
+   * @brief getChanges Get the tiles changed by the last step.
+   * @return
+   */
+    const std::vector<TileChange> &getChanges() const { return changes; }
+
+private:
+    /**
+   * @brief advance Execute next block without looking for repeated states.
+   */
+    void advance();
+
+    /**
+   * @brief lookFurther Find out from origin whether and where the run first
+   * repeats a state, looking at least up to a tick, and update knownUntil
+   * and repeatTick.
+   * @param tick
+   */
+    void lookFurther(int tick);
+
+    template <class Simulation>
+    friend RepeatSearch findRepeat(const Simulation &start, int tick);
+
+    void execute(const Instruction &instruction);
+    void moveRobot();
+    void setLost();
+    void setTile(int x, int y, unsigned char bits);
+    std::uint64_t getStateHash() const;
+};
+
+#endif // WORLDSIMULATION_H
@@ -0,0 +1,50 @@
+/**
+ * @file zobrist.h
+ * @brief Zobrist style keys used to fingerprint simulation states.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+/**
+ * @brief mixHash Scramble a 64 bit value (splitmix64 finalizer). Keys are
+ * derived on demand instead of stored in per-cell tables, so huge maps cost
+ * nothing up front.
+ * @param value
+ * @return
+ */
+inline std::uint64_t mixHash(std::uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief blockKey Key XORed into the map hash while a block sits on a cell.
+ * @param cell
+ * @return
+ */
+inline std::uint64_t blockKey(int cell) {
+    return mixHash(((std::uint64_t)cell << 2) | 1);
+}
+
+/**
+ * @brief robotKey Key for the program counter, robot cell and heading.
+ * @param pc
+ * @param cell
+ * @param dir
+ * @return
+ */
+inline std::uint64_t robotKey(int pc, int cell, int dir) {
+    return mixHash(((std::uint64_t)pc << 40) ^ ((std::uint64_t)(unsigned)cell << 2) ^
+                   (std::uint64_t)dir ^ 0x5bd1e995ULL);
+}
+
+#endif // ZOBRIST_H